@@ -76,24 +76,31 @@ struct animation_hook : public animation_hook_base
     std::unique_ptr<animation_base> animation;
     std::shared_ptr<wf::unmapped_view_snapshot_node> unmapped_contents;
 
-    void damage_whole_view()
+    void damage_whole_view(wf::animation_frame_t& frame)
     {
-        view->damage();
+        frame.damage_node(view->get_transformed_node());
         if (unmapped_contents)
         {
-            wf::scene::damage_node(unmapped_contents, unmapped_contents->get_bounding_box());
+            frame.damage_node(unmapped_contents);
         }
     }
 
     /* Update animation right before each frame */
-    wf::effect_hook_t update_animation_hook = [=] ()
+    wf::animation_hook_t update_animation_hook = [=] (wf::animation_frame_t& frame)
     {
-        damage_whole_view();
-        bool result = animation->step();
-        damage_whole_view();
+        damage_whole_view(frame);
 
+        // Nobody can see the animation on a suspended output, so just finish it.
+        bool result = !frame.suspended && animation->step();
         if (!result)
         {
+            // The nodes may be removed from the scenegraph when the animation ends.
+            frame.flush_damage(view->get_transformed_node());
+            if (unmapped_contents)
+            {
+                frame.flush_damage(unmapped_contents);
+            }
+
             stop_hook(false);
         }
     };
@@ -106,13 +113,12 @@ struct animation_hook : public animation_hook_base
     {
         if (current_output)
         {
-            current_output->render->rem_effect(&update_animation_hook);
+            current_output->render->rem_animation(&update_animation_hook);
         }
 
         if (new_output)
         {
-            new_output->render->add_effect(&update_animation_hook,
-                wf::OUTPUT_EFFECT_PRE);
+            new_output->render->add_animation(&update_animation_hook);
         }
 
         current_output = new_output;
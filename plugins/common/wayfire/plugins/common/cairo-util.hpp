@@ -38,6 +38,8 @@ static void cairo_surface_upload_to_texture(
     GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED));
     GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
         buffer.width, buffer.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, src));
+    wf::gpu_resources::track_texture(buffer.tex, buffer.width, buffer.height,
+        (const void*)&cairo_surface_upload_to_texture);
 }
 
 namespace wf
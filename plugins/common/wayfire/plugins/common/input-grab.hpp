@@ -2,12 +2,15 @@
 
 #include "wayfire/core.hpp"
 #include "wayfire/output.hpp"
+#include "wayfire/render-manager.hpp"
 #include "wayfire/scene-input.hpp"
 #include "wayfire/scene-operations.hpp"
 #include "wayfire/scene.hpp"
 #include <wayfire/debug.hpp>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 #include <wayfire/seat.hpp>
 namespace wf
 {
@@ -44,6 +47,11 @@ class grab_node_t : public node_t
         this->m_flags = add_flags;
     }
 
+    void set_pointer_interaction(pointer_interaction_t *pointer)
+    {
+        this->pointer = pointer;
+    }
+
     std::optional<input_node_t> find_node_at(const wf::pointf_t& at) override
     {
         if (output->get_layout_geometry() & at)
@@ -98,6 +106,152 @@ class grab_node_t : public node_t
 };
 }
 
+/**
+ * A single pointer motion event, as received from core.
+ */
+struct pointer_motion_sample_t
+{
+    wf::pointf_t position;
+    uint32_t time_ms;
+};
+
+/**
+ * A pointer interaction which forwards events to another pointer interaction, but delivers at most one
+ * motion event per frame of the given output. See input_grab_t::set_coalesce_pointer_motion().
+ *
+ * Other events (button, axis, enter and leave) are forwarded immediately. Any pending motion is delivered
+ * before them, so that the target always sees events in the order in which they happened.
+ */
+class coalescing_pointer_interaction_t : public pointer_interaction_t
+{
+    wf::output_t *output;
+    pointer_interaction_t *target;
+
+    bool keep_history = false;
+    std::vector<pointer_motion_sample_t> history;
+    std::optional<pointer_motion_sample_t> pending;
+
+    bool hook_connected = false;
+    wf::effect_hook_t on_frame = [=] ()
+    {
+        flush();
+    };
+
+  public:
+    coalescing_pointer_interaction_t(wf::output_t *output, pointer_interaction_t *target)
+    {
+        this->output = output;
+        this->target = target;
+    }
+
+    ~coalescing_pointer_interaction_t()
+    {
+        discard();
+    }
+
+    /**
+     * Set whether all motion events since the last delivered one should be kept, see get_history().
+     */
+    void set_keep_history(bool keep)
+    {
+        this->keep_history = keep;
+        if (!keep)
+        {
+            history.clear();
+        }
+    }
+
+    /**
+     * Get all motion events which were coalesced into the motion event currently being delivered, in the
+     * order they happened. Only available from within handle_pointer_motion() of the target, and only if
+     * set_keep_history(true) was called.
+     */
+    const std::vector<pointer_motion_sample_t>& get_history() const
+    {
+        return history;
+    }
+
+    /**
+     * Deliver the pending motion event, if any.
+     */
+    void flush()
+    {
+        if (!pending)
+        {
+            return;
+        }
+
+        auto sample = *pending;
+        pending.reset();
+        target->handle_pointer_motion(sample.position, sample.time_ms);
+        history.clear();
+    }
+
+    /**
+     * Drop the pending motion event, if any, and stop waiting for frames.
+     */
+    void discard()
+    {
+        pending.reset();
+        history.clear();
+        if (hook_connected)
+        {
+            output->render->rem_effect(&on_frame);
+            hook_connected = false;
+        }
+    }
+
+    void handle_pointer_enter(wf::pointf_t position) override
+    {
+        flush();
+        target->handle_pointer_enter(position);
+    }
+
+    void handle_pointer_leave() override
+    {
+        flush();
+        target->handle_pointer_leave();
+    }
+
+    void handle_pointer_button(const wlr_pointer_button_event& event) override
+    {
+        flush();
+        target->handle_pointer_button(event);
+    }
+
+    void handle_pointer_axis(const wlr_pointer_axis_event& event) override
+    {
+        flush();
+        target->handle_pointer_axis(event);
+    }
+
+    void handle_pointer_motion(wf::pointf_t position, uint32_t time_ms) override
+    {
+        if (keep_history)
+        {
+            history.push_back({position, time_ms});
+        }
+
+        pending = pointer_motion_sample_t{position, time_ms};
+        if (!output->handle->enabled)
+        {
+            // There will be no frame to wait for.
+            flush();
+            return;
+        }
+
+        if (!hook_connected)
+        {
+            // Deliver the motion right before the next frame is painted, so that its effects (for example
+            // a moved view) are visible in that frame.
+            output->render->add_effect(&on_frame, OUTPUT_EFFECT_PRE);
+            hook_connected = true;
+        }
+
+        output->render->schedule_redraw();
+    }
+};
+
 /**
  * A helper class for managing input grabs on an output.
  */
@@ -105,6 +259,8 @@ class input_grab_t
 {
     wf::output_t *output;
     std::shared_ptr<scene::grab_node_t> grab_node;
+    pointer_interaction_t *pointer;
+    std::unique_ptr<coalescing_pointer_interaction_t> coalescing_pointer;
 
   public:
     input_grab_t(std::string name, wf::output_t *output,
@@ -112,8 +268,55 @@ class input_grab_t
         pointer_interaction_t *pointer   = NULL,
         touch_interaction_t *touch = NULL)
     {
-        this->output = output;
-        grab_node    = std::make_shared<scene::grab_node_t>(name, output, keyboard, pointer, touch);
+        this->output  = output;
+        this->pointer = pointer;
+        grab_node     = std::make_shared<scene::grab_node_t>(name, output, keyboard, pointer, touch);
+    }
+
+    /**
+     * Enable or disable coalescing of pointer motion events.
+     *
+     * By default, the pointer interaction of the grab receives every motion event from the input device,
+     * which may be thousands of events per second. With coalescing enabled, motion events are accumulated
+     * and only the latest one is delivered, right before the output of the grab paints its next frame.
+     * This is useful for grabs whose motion handling is expensive, for example moving a view.
+     *
+     * @param coalesce Whether to coalesce motion events.
+     * @param keep_history Whether to also keep the individual coalesced events, so that they can be
+     *   retrieved with get_pointer_motion_history().
+     */
+    void set_coalesce_pointer_motion(bool coalesce, bool keep_history = false)
+    {
+        if (!pointer)
+        {
+            return;
+        }
+
+        if (coalesce)
+        {
+            if (!coalescing_pointer)
+            {
+                coalescing_pointer = std::make_unique<coalescing_pointer_interaction_t>(output, pointer);
+            }
+
+            coalescing_pointer->set_keep_history(keep_history);
+            grab_node->set_pointer_interaction(coalescing_pointer.get());
+        } else if (coalescing_pointer)
+        {
+            coalescing_pointer->flush();
+            grab_node->set_pointer_interaction(pointer);
+            coalescing_pointer.reset();
+        }
+    }
+
+    /**
+     * Get the individual motion events which were coalesced into the motion event currently being
+     * delivered. Empty unless motion coalescing with history is enabled.
+     */
+    const std::vector<pointer_motion_sample_t>& get_pointer_motion_history() const
+    {
+        static const std::vector<pointer_motion_sample_t> empty;
+        return coalescing_pointer ? coalescing_pointer->get_history() : empty;
     }
 
     /**
@@ -184,6 +387,11 @@ class input_grab_t
      */
     void ungrab_input()
     {
+        if (coalescing_pointer)
+        {
+            coalescing_pointer->discard();
+        }
+
         if (grab_node->parent())
         {
             wf::scene::remove_child(grab_node, scene::update_flag::REFOCUS);
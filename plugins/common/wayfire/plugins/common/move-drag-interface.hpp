@@ -13,6 +13,7 @@
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/view-helpers.hpp"
 #include <memory>
+#include <typeinfo>
 #include <wayfire/nonstd/reverse.hpp>
 #include <wayfire/plugins/common/util.hpp>
 #include <wayfire/plugins/wobbly/wobbly-signal.hpp>
@@ -26,6 +27,7 @@
 #include <wayfire/util/duration.hpp>
 #include <wayfire/util/log.hpp>
 #include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/window-manager.hpp>
 
@@ -161,7 +163,8 @@ inline static wf::pointf_t find_relative_grab(
  * It is primarily used to scale the view is a plugin needs it, and also to keep it
  * centered around the `grab_position`.
  */
-class scale_around_grab_t : public wf::scene::transformer_base_node_t
+class scale_around_grab_t : public wf::scene::transformer_base_node_t,
+    public wf::scene::affine_transformer_node_t
 {
   public:
     /**
@@ -224,6 +227,29 @@ class scale_around_grab_t : public wf::scene::transformer_base_node_t
         return find_geometry_around({w, h}, grab_position, relative_grab);
     }
 
+    glm::mat4 get_affine_transform() override
+    {
+        // Map the children's bounding box to our bounding box.
+        auto children = get_children_bounding_box();
+        auto bbox     = get_bounding_box();
+        auto to_origin = glm::translate(glm::mat4(1.0), glm::vec3{-children.x, -children.y, 0.0});
+        auto scale     = glm::scale(glm::mat4(1.0), glm::vec3{
+            1.0 * bbox.width / std::max(children.width, 1),
+            1.0 * bbox.height / std::max(children.height, 1), 1.0});
+        auto translate = glm::translate(glm::mat4(1.0), glm::vec3{bbox.x, bbox.y, 0.0});
+        return translate * scale * to_origin;
+    }
+
+    float get_alpha_multiplier() override
+    {
+        return alpha_factor;
+    }
+
+    bool can_fuse() override
+    {
+        return typeid(*this) == typeid(scale_around_grab_t);
+    }
+
     class render_instance_t :
         public scene::transformer_render_instance_t<scale_around_grab_t>
     {
@@ -239,13 +265,26 @@ class scale_around_grab_t : public wf::scene::transformer_base_node_t
             const wf::region_t& region) override
         {
             auto bbox = self->get_bounding_box();
-            auto tex  = this->get_texture(target.scale);
+            auto matrix = target.get_orthographic_projection();
+            double alpha = self->alpha_factor;
+
+            wf::texture_t tex;
+            if (auto fused = this->fused_texture())
+            {
+                tex    = fused->texture;
+                bbox   = fused->geometry;
+                matrix = matrix * self->get_affine_transform() * fused->transform;
+                alpha *= fused->alpha;
+            } else
+            {
+                tex = this->get_texture(target.scale);
+            }
 
             OpenGL::render_begin(target);
             for (auto& rect : region)
             {
                 target.logic_scissor(wlr_box_from_pixman_box(rect));
-                OpenGL::render_texture(tex, target, bbox, glm::vec4{1, 1, 1, (double)self->alpha_factor});
+                OpenGL::render_transformed_texture(tex, bbox, matrix, glm::vec4{1, 1, 1, alpha});
             }
 
             OpenGL::render_end();
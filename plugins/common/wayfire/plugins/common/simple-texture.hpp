@@ -1,5 +1,6 @@
 #pragma once
 #include <wayfire/opengl.hpp>
+#include <wayfire/gpu-resources.hpp>
 
 namespace wf
 {
@@ -21,6 +22,7 @@ struct simple_texture_t
         }
 
         OpenGL::render_begin();
+        wf::gpu_resources::untrack_texture(tex);
         GL_CALL(glDeleteTextures(1, &tex));
         OpenGL::render_end();
         this->tex = -1;
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+#include "wayfire/core.hpp"
+#include "wayfire/debug.hpp"
+#include "wayfire/geometry.hpp"
+#include "wayfire/opengl.hpp"
+#include "wayfire/option-wrapper.hpp"
+#include "wayfire/output.hpp"
+#include "wayfire/output-layout.hpp"
+#include "wayfire/region.hpp"
+#include "wayfire/scene-render.hpp"
+#include "wayfire/scene.hpp"
+#include "wayfire/signal-definitions.hpp"
+#include "wayfire/signal-provider.hpp"
+#include "wayfire/util.hpp"
+#include "wayfire/workspace-set.hpp"
+#include "wayfire/workspace-stream.hpp"
+#include <wayfire/plugins/common/shared-core-data.hpp>
+
+namespace wf
+{
+/**
+ * A low-resolution thumbnail of a single workspace.
+ */
+struct workspace_thumbnail_t
+{
+    /**
+     * The buffer containing the thumbnail. Its geometry is the same as the bounding box of the workspace
+     * stream of the workspace, i.e. (0, 0, output_width, output_height).
+     */
+    wf::render_target_t buffer;
+
+    /** Whether the buffer contains a (possibly slightly outdated) image of the workspace. */
+    bool valid = false;
+};
+
+/**
+ * The workspace thumbnail cache keeps low-resolution thumbnails of all workspaces on all outputs.
+ *
+ * Thumbnails are refreshed lazily: damage to a workspace is only accumulated, and the thumbnails are
+ * re-rendered in idle time, at most once per refresh interval and at most one workspace per iteration.
+ * While no workspace wall is shown, only missing thumbnails are rendered, so that constant damage (for
+ * example a playing video) does not keep the cache busy. Damaged thumbnails are refreshed once a wall
+ * is shown again. The resolution and the refresh interval are set by the core/workspace_thumbnail_scale
+ * and core/workspace_thumbnail_refresh_interval options.
+ *
+ * Plugins like expo and vswitch may use them to show the workspaces immediately when they start, and
+ * switch to live rendering once they have had time to render the workspaces at full resolution.
+ *
+ * The cache is opt-in: it is only active as long as at least one plugin holds a reference to it:
+ *
+ * ```
+ * wf::shared_data::ref_ptr_t<wf::workspace_thumbnail_cache_t> thumbnails;
+ * ```
+ *
+ * Users which only want to use the thumbnails if they already exist (like workspace_wall_t) should use
+ * workspace_thumbnail_cache_t::get_if_active() instead.
+ */
+class workspace_thumbnail_cache_t
+{
+  public:
+    workspace_thumbnail_cache_t()
+    {
+        wf::get_core().output_layout->connect(&on_output_removed);
+        wf::get_core().scene()->connect(&on_root_update);
+        scale_opt.set_callback([=] () { set_scale(scale_opt); });
+        refresh_interval_opt.set_callback([=] () { set_refresh_interval(refresh_interval_opt); });
+        set_scale(scale_opt);
+        set_refresh_interval(refresh_interval_opt);
+        refresh_all();
+    }
+
+    ~workspace_thumbnail_cache_t()
+    {
+        OpenGL::render_begin();
+        for (auto& [_, cache] : outputs)
+        {
+            cache->release_buffers();
+        }
+
+        OpenGL::render_end();
+    }
+
+    workspace_thumbnail_cache_t(const workspace_thumbnail_cache_t&) = delete;
+    workspace_thumbnail_cache_t(workspace_thumbnail_cache_t&&) = delete;
+    workspace_thumbnail_cache_t& operator =(const workspace_thumbnail_cache_t&) = delete;
+    workspace_thumbnail_cache_t& operator =(workspace_thumbnail_cache_t&&) = delete;
+
+    /**
+     * @return The thumbnail cache if at least one plugin holds a reference to it, nullptr otherwise.
+     */
+    static workspace_thumbnail_cache_t *get_if_active()
+    {
+        using data_t = shared_data::detail::shared_data_t<workspace_thumbnail_cache_t>;
+        auto data = wf::get_core().get_data<data_t>();
+        return data ? &data->data : nullptr;
+    }
+
+    /**
+     * Set the resolution of the thumbnails relative to the output resolution. Changing the scale
+     * invalidates all thumbnails.
+     */
+    void set_scale(float scale)
+    {
+        scale = std::clamp(scale, MIN_SCALE, 1.0f);
+        if (scale != this->scale)
+        {
+            this->scale = scale;
+            refresh_all();
+        }
+    }
+
+    /**
+     * Set the minimal time between two thumbnail updates, in milliseconds.
+     */
+    void set_refresh_interval(int interval_ms)
+    {
+        this->refresh_interval = std::max(interval_ms, 0);
+    }
+
+    /**
+     * Mark a workspace wall as shown or hidden. Damaged thumbnails are refreshed only while at least
+     * one wall is shown. workspace_wall_t does this automatically.
+     */
+    void set_wall_shown(const void *wall, bool shown)
+    {
+        if (shown)
+        {
+            shown_walls.insert(wall);
+            schedule_refresh();
+        } else
+        {
+            shown_walls.erase(wall);
+        }
+    }
+
+    /**
+     * Get the thumbnail of the given workspace.
+     *
+     * @return The thumbnail, or nullptr if no valid thumbnail exists yet.
+     */
+    const workspace_thumbnail_t *get_thumbnail(wf::output_t *output, wf::point_t ws)
+    {
+        auto it = outputs.find(output);
+        if ((it == outputs.end()) || !it->second->is_up_to_date())
+        {
+            return nullptr;
+        }
+
+        auto& thumbnails = it->second->thumbnails;
+        if ((ws.x < 0) || (ws.x >= (int)thumbnails.size()) ||
+            (ws.y < 0) || (ws.y >= (int)thumbnails[ws.x].size()) ||
+            !thumbnails[ws.x][ws.y].valid)
+        {
+            return nullptr;
+        }
+
+        return &thumbnails[ws.x][ws.y];
+    }
+
+  private:
+    static constexpr float MIN_SCALE = 0.05;
+
+    wf::option_wrapper_t<double> scale_opt{"core/workspace_thumbnail_scale"};
+    wf::option_wrapper_t<int> refresh_interval_opt{"core/workspace_thumbnail_refresh_interval"};
+    float scale = 0.25;
+    int refresh_interval = 100;
+
+    /** The walls which are currently shown, see set_wall_shown(). */
+    std::set<const void*> shown_walls;
+
+    struct output_cache_t
+    {
+        workspace_thumbnail_cache_t *cache;
+        wf::output_t *output;
+
+        wf::dimensions_t grid_size;
+        wf::dimensions_t output_size;
+        float buffer_scale;
+
+        std::vector<std::vector<std::shared_ptr<workspace_stream_node_t>>> streams;
+        std::vector<std::vector<std::vector<scene::render_instance_uptr>>> instances;
+        std::vector<std::vector<wf::region_t>> damage;
+        std::vector<std::vector<workspace_thumbnail_t>> thumbnails;
+
+        output_cache_t(workspace_thumbnail_cache_t *cache, wf::output_t *output)
+        {
+            this->cache  = cache;
+            this->output = output;
+
+            grid_size    = output->wset()->get_workspace_grid_size();
+            output_size  = output->get_screen_size();
+            buffer_scale = output->handle->scale * cache->scale;
+
+            streams.resize(grid_size.width);
+            instances.resize(grid_size.width);
+            damage.resize(grid_size.width);
+            thumbnails.resize(grid_size.width);
+            for (int i = 0; i < grid_size.width; i++)
+            {
+                instances[i].resize(grid_size.height);
+                damage[i].resize(grid_size.height);
+                thumbnails[i].resize(grid_size.height);
+                for (int j = 0; j < grid_size.height; j++)
+                {
+                    streams[i].push_back(std::make_shared<workspace_stream_node_t>(output,
+                        wf::point_t{i, j}));
+
+                    auto& buffer = thumbnails[i][j].buffer;
+                    buffer.geometry = streams[i][j]->get_bounding_box();
+                    buffer.scale    = buffer_scale;
+                    buffer.wl_transform = WL_OUTPUT_TRANSFORM_NORMAL;
+                    buffer.transform    = get_output_matrix_from_transform(buffer.wl_transform);
+                    damage[i][j] |= buffer.geometry;
+                }
+            }
+
+            regenerate_instances();
+        }
+
+        /**
+         * @return Whether the output is still in the same configuration as when the cache was created.
+         */
+        bool is_up_to_date() const
+        {
+            return (output->wset()->get_workspace_grid_size() == grid_size) &&
+                   (output->get_screen_size() == output_size) &&
+                   (output->handle->scale * cache->scale == buffer_scale);
+        }
+
+        void regenerate_instances()
+        {
+            for (int i = 0; i < grid_size.width; i++)
+            {
+                for (int j = 0; j < grid_size.height; j++)
+                {
+                    auto push_damage = [=] (const wf::region_t& region)
+                    {
+                        damage[i][j] |= region;
+                        if (!thumbnails[i][j].valid || !cache->shown_walls.empty())
+                        {
+                            cache->schedule_refresh();
+                        }
+                    };
+
+                    instances[i][j].clear();
+                    streams[i][j]->gen_render_instances(instances[i][j], push_damage, output);
+                }
+            }
+        }
+
+        /**
+         * Re-render the damaged workspace which has the most accumulated damage.
+         *
+         * @param only_missing Whether to consider only workspaces without a valid thumbnail.
+         * @return Whether a workspace was rendered.
+         */
+        bool refresh_one(bool only_missing)
+        {
+            int best_i = -1, best_j = -1;
+            int64_t best_area = 0;
+            for (int i = 0; i < grid_size.width; i++)
+            {
+                for (int j = 0; j < grid_size.height; j++)
+                {
+                    if (only_missing && thumbnails[i][j].valid)
+                    {
+                        continue;
+                    }
+
+                    int64_t area = 0;
+                    for (auto& rect : damage[i][j])
+                    {
+                        area += int64_t(rect.x2 - rect.x1) * (rect.y2 - rect.y1);
+                    }
+
+                    if (area > best_area)
+                    {
+                        best_area = area;
+                        best_i    = i;
+                        best_j    = j;
+                    }
+                }
+            }
+
+            if (best_i < 0)
+            {
+                return false;
+            }
+
+            auto& thumb = thumbnails[best_i][best_j];
+            auto size   = thumb.buffer.framebuffer_box_from_geometry_box(thumb.buffer.geometry);
+            OpenGL::render_begin();
+            if (thumb.buffer.allocate(size.width, size.height))
+            {
+                damage[best_i][best_j] |= thumb.buffer.geometry;
+            }
+
+            OpenGL::render_end();
+
+            scene::render_pass_params_t params;
+            params.instances = &instances[best_i][best_j];
+            params.damage    = damage[best_i][best_j] & thumb.buffer.geometry;
+            params.reference_output = output;
+            params.target = thumb.buffer;
+            scene::run_render_pass(params, scene::RPASS_EMIT_SIGNALS);
+
+            damage[best_i][best_j].clear();
+            thumb.valid = true;
+            return true;
+        }
+
+        void release_buffers()
+        {
+            for (auto& column : thumbnails)
+            {
+                for (auto& thumb : column)
+                {
+                    thumb.buffer.release();
+                    thumb.valid = false;
+                }
+            }
+        }
+    };
+
+    std::map<wf::output_t*, std::unique_ptr<output_cache_t>> outputs;
+
+    wf::wl_timer<false> refresh_timer;
+    wf::wl_idle_call idle_refresh;
+
+    void refresh_all()
+    {
+        OpenGL::render_begin();
+        for (auto& [_, cache] : outputs)
+        {
+            cache->release_buffers();
+        }
+
+        OpenGL::render_end();
+        outputs.clear();
+        schedule_refresh();
+    }
+
+    void schedule_refresh()
+    {
+        if (refresh_timer.is_connected() || idle_refresh.is_connected())
+        {
+            return;
+        }
+
+        refresh_timer.set_timeout(refresh_interval, [=] ()
+        {
+            idle_refresh.run_once([=] () { refresh_step(); });
+        });
+    }
+
+    /**
+     * Update a single workspace thumbnail, then wait for the next idle iteration to continue.
+     * This way, updating the thumbnails never delays input processing or rendering by much.
+     */
+    void refresh_step()
+    {
+        for (auto& wo : wf::get_core().output_layout->get_outputs())
+        {
+            auto& cache = outputs[wo];
+            if (!cache || !cache->is_up_to_date())
+            {
+                OpenGL::render_begin();
+                if (cache)
+                {
+                    cache->release_buffers();
+                }
+
+                OpenGL::render_end();
+                cache = std::make_unique<output_cache_t>(this, wo);
+            }
+
+            if (cache->refresh_one(shown_walls.empty()))
+            {
+                idle_refresh.run_once([=] () { refresh_step(); });
+                return;
+            }
+        }
+    }
+
+    wf::signal::connection_t<wf::output_removed_signal> on_output_removed =
+        [=] (wf::output_removed_signal *ev)
+    {
+        auto it = outputs.find(ev->output);
+        if (it != outputs.end())
+        {
+            OpenGL::render_begin();
+            it->second->release_buffers();
+            OpenGL::render_end();
+            outputs.erase(it);
+        }
+    };
+
+    wf::signal::connection_t<scene::root_node_update_signal> on_root_update =
+        [=] (scene::root_node_update_signal *ev)
+    {
+        constexpr uint32_t recompute_instances_on = scene::update_flag::CHILDREN_LIST |
+            scene::update_flag::ENABLED;
+        if (!(ev->flags & recompute_instances_on) || (ev->flags & scene::update_flag::MASKED))
+        {
+            return;
+        }
+
+        for (auto& [_, cache] : outputs)
+        {
+            cache->regenerate_instances();
+        }
+
+        schedule_refresh();
+    };
+};
+}
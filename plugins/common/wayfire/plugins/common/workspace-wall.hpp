@@ -3,8 +3,13 @@
 
 #include "wayfire/workspace-set.hpp" // IWYU pragma: keep
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <chrono>
 #include <memory>
+#include <vector>
 #include "wayfire/core.hpp"
+#include "wayfire/debug.hpp"
+#include "wayfire/framebuffer-pool.hpp"
 #include "wayfire/geometry.hpp"
 #include "wayfire/opengl.hpp"
 #include "wayfire/region.hpp"
@@ -15,6 +20,7 @@
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/workspace-stream.hpp"
 #include "wayfire/output.hpp"
+#include <wayfire/plugins/common/workspace-thumbnail-cache.hpp>
 
 namespace wf
 {
@@ -31,6 +37,42 @@ struct wall_frame_event_t
     {}
 };
 
+/**
+ * A visible workspace whose buffer a workspace wall may update in the current frame.
+ */
+struct workspace_wall_update_t
+{
+    int i, j;
+    /** Whether this is the current workspace of the output */
+    bool focused;
+    /** The area of the workspace which is visible in the viewport */
+    int visible_area;
+    /** For how many frames in a row the update was deferred because of the update budget */
+    int skipped_frames;
+};
+
+/**
+ * Sort the workspace updates in the order in which a workspace wall performs them: the current workspace
+ * first, then the workspaces which have been deferred the longest, then the larger ones.
+ */
+inline void sort_workspace_wall_updates(std::vector<workspace_wall_update_t>& order)
+{
+    std::stable_sort(order.begin(), order.end(), [&] (const auto& a, const auto& b)
+    {
+        if (a.focused != b.focused)
+        {
+            return a.focused;
+        }
+
+        if (a.skipped_frames != b.skipped_frames)
+        {
+            return a.skipped_frames > b.skipped_frames;
+        }
+
+        return a.visible_area > b.visible_area;
+    });
+}
+
 /**
  * A helper class to render workspaces arranged in a grid.
  */
@@ -97,6 +139,24 @@ class workspace_wall_t : public wf::signal::provider_t
         return viewport;
     }
 
+    /**
+     * Set the maximal time which may be spent per frame on updating the workspace buffers.
+     *
+     * Workspaces which do not fit into the budget keep their old contents and are updated on one of the
+     * next frames. The current workspace is always updated first, followed by the workspaces which have
+     * waited the longest and by those which cover the largest part of the viewport. At least one workspace
+     * is updated per frame, regardless of the budget.
+     *
+     * A new wall has no budget and updates all workspaces each frame. Expo and vswitch set the budget from
+     * their update_budget options, which default to 8ms.
+     *
+     * @param budget_ms The budget in milliseconds, or 0 to update all workspaces each frame.
+     */
+    void set_update_budget(int budget_ms)
+    {
+        this->update_budget = std::chrono::milliseconds(std::max(budget_ms, 0));
+    }
+
     /**
      * Render the selected viewport on the framebuffer.
      *
@@ -119,6 +179,10 @@ class workspace_wall_t : public wf::signal::provider_t
         wf::dassert(render_node == nullptr, "Starting workspace-wall twice?");
         render_node = std::make_shared<workspace_wall_node_t>(this);
         scene::add_front(wf::get_core().scene(), render_node);
+        if (auto cache = workspace_thumbnail_cache_t::get_if_active())
+        {
+            cache->set_wall_shown(this, true);
+        }
     }
 
     /**
@@ -136,6 +200,10 @@ class workspace_wall_t : public wf::signal::provider_t
 
         scene::remove_child(render_node);
         render_node = nullptr;
+        if (auto cache = workspace_thumbnail_cache_t::get_if_active())
+        {
+            cache->set_wall_shown(this, false);
+        }
 
         if (reset_viewport)
         {
@@ -195,6 +263,7 @@ class workspace_wall_t : public wf::signal::provider_t
     wf::color_t background_color = {0, 0, 0, 0};
     int gap_size = 0;
     wf::geometry_t viewport = {0, 0, 0, 0};
+    std::chrono::microseconds update_budget{0};
 
     std::map<std::pair<int, int>, float> render_colors;
 
@@ -353,35 +422,126 @@ class workspace_wall_t : public wf::signal::provider_t
                 return false;
             }
 
-            void schedule_instructions(
-                std::vector<scene::render_instruction_t>& instructions,
-                const wf::render_target_t& target, wf::region_t& damage) override
+            /**
+             * Workspaces whose buffers were not updated in the last frame because the update budget was
+             * exhausted. Once the frame is done, their screen area is damaged again so that they are
+             * updated on one of the next frames.
+             */
+            std::vector<wf::point_t> deferred_workspaces;
+            wf::wl_idle_call idle_damage_deferred;
+
+            /**
+             * Get the workspaces which are visible in the viewport, in the order in which their buffers
+             * should be updated.
+             */
+            std::vector<workspace_wall_update_t> get_workspace_update_order()
             {
-                // Update workspaces in a render pass
+                const auto current_ws = self->wall->output->wset()->get_current_workspace();
+
+                std::vector<workspace_wall_update_t> order;
                 for (int i = 0; i < (int)self->workspaces.size(); i++)
                 {
                     for (int j = 0; j < (int)self->workspaces[i].size(); j++)
                     {
-                        const auto ws_bbox     = self->wall->get_workspace_rectangle({i, j});
-                        const auto visible_box =
-                            geometry_intersection(self->wall->viewport, ws_bbox) - wf::origin(ws_bbox);
-                        wf::region_t visible_damage = self->aux_buffer_damage[i][j] & visible_box;
-                        if (consider_rescale_workspace_buffer(i, j, visible_damage))
+                        const auto ws_bbox = self->wall->get_workspace_rectangle({i, j});
+                        const auto visible = geometry_intersection(self->wall->viewport, ws_bbox);
+                        if ((visible.width <= 0) || (visible.height <= 0))
                         {
-                            visible_damage |= visible_box;
+                            continue;
                         }
 
-                        if (!visible_damage.empty())
+                        order.push_back({i, j, current_ws == wf::point_t{i, j},
+                            visible.width * visible.height, self->aux_buffer_skipped_frames[i][j]});
+                    }
+                }
+
+                sort_workspace_wall_updates(order);
+                return order;
+            }
+
+            void damage_deferred_workspaces()
+            {
+                wf::region_t damage;
+                for (auto& ws : deferred_workspaces)
+                {
+                    auto A = self->wall->viewport;
+                    auto B = self->get_bounding_box();
+                    damage |= scale_box(A, B, get_workspace_rect(ws));
+                }
+
+                deferred_workspaces.clear();
+                push_damage(damage);
+            }
+
+            void schedule_instructions(
+                std::vector<scene::render_instruction_t>& instructions,
+                const wf::render_target_t& target, wf::region_t& damage) override
+            {
+                using namespace std::chrono;
+                const auto budget = self->wall->update_budget;
+                const auto start  = steady_clock::now();
+                int nr_updated    = 0;
+
+                // Update workspaces in a render pass
+                for (auto& ws : get_workspace_update_order())
+                {
+                    const int i = ws.i;
+                    const int j = ws.j;
+                    const auto ws_bbox     = self->wall->get_workspace_rectangle({i, j});
+                    const auto visible_box =
+                        geometry_intersection(self->wall->viewport, ws_bbox) - wf::origin(ws_bbox);
+
+                    // Workspaces shown from a cached thumbnail are switched to live rendering one at a time,
+                    // so that starting the wall does not render all workspaces in the first frame.
+                    const bool over_budget = (nr_updated > 0) &&
+                        (self->has_thumbnail(i, j) ||
+                         ((budget.count() > 0) && (steady_clock::now() - start >= budget)));
+                    if (over_budget)
+                    {
+                        // Keep the accumulated damage for the next frames.
+                        if (!(self->aux_buffer_damage[i][j] & visible_box).empty())
                         {
-                            scene::render_pass_params_t params;
-                            params.instances = &instances[i][j];
-                            params.damage    = std::move(visible_damage);
-                            params.reference_output = self->wall->output;
-                            params.target = self->aux_buffers[i][j];
-                            scene::run_render_pass(params, scene::RPASS_EMIT_SIGNALS);
-                            self->aux_buffer_damage[i][j] ^= visible_damage;
+                            ++self->aux_buffer_skipped_frames[i][j];
+                            deferred_workspaces.push_back({i, j});
                         }
+
+                        continue;
+                    }
+
+                    wf::region_t visible_damage = self->aux_buffer_damage[i][j] & visible_box;
+                    if (consider_rescale_workspace_buffer(i, j, visible_damage))
+                    {
+                        visible_damage |= visible_box;
+                    }
+
+                    if (!visible_damage.empty())
+                    {
+                        scene::render_pass_params_t params;
+                        params.instances = &instances[i][j];
+                        params.damage    = std::move(visible_damage);
+                        params.reference_output = self->wall->output;
+                        params.target = self->aux_buffers[i][j];
+                        scene::run_render_pass(params, scene::RPASS_EMIT_SIGNALS);
+                        self->aux_buffer_damage[i][j] ^= visible_damage;
+                        self->aux_buffer_skipped_frames[i][j] = 0;
+                        ++nr_updated;
                     }
+
+                    if (self->has_thumbnail(i, j))
+                    {
+                        // Make sure the whole workspace is repainted from the live buffer
+                        self->aux_buffer_use_thumbnail[i][j] = false;
+                        damage |= scale_box(self->wall->viewport, self->get_bounding_box(),
+                            get_workspace_rect({i, j}));
+                    }
+                }
+
+                if (!deferred_workspaces.empty())
+                {
+                    LOGC(RENDER, "workspace-wall: updated ", nr_updated, " workspaces in ",
+                        duration_cast<microseconds>(steady_clock::now() - start).count(), "us, deferred ",
+                        deferred_workspaces.size());
+                    idle_damage_deferred.run_once([=] () { damage_deferred_workspaces(); });
                 }
 
                 // Render the wall
@@ -428,7 +588,11 @@ class workspace_wall_t : public wf::signal::provider_t
                             float dim = self->wall->get_color_for_workspace({i, j});
                             const glm::vec4 color = glm::vec4(dim, dim, dim, 1.0);
 
-                            if (!buffer.subbuffer.has_value())
+                            if (auto thumb = self->get_thumbnail(i, j))
+                            {
+                                OpenGL::render_transformed_texture({thumb->buffer.tex},
+                                    render_geometry, {}, target.get_orthographic_projection(), color);
+                            } else if (!buffer.subbuffer.has_value())
                             {
                                 OpenGL::render_transformed_texture({buffer.tex},
                                     render_geometry, {}, target.get_orthographic_projection(), color);
@@ -494,11 +658,13 @@ class workspace_wall_t : public wf::signal::provider_t
                     auto size =
                         aux_buffers[i][j].framebuffer_box_from_geometry_box(aux_buffers[i][j].geometry);
                     OpenGL::render_begin();
-                    aux_buffers[i][j].allocate(size.width, size.height);
+                    wf::get_framebuffer_pool().allocate(aux_buffers[i][j], size.width, size.height);
                     OpenGL::render_end();
 
                     aux_buffer_damage[i][j] |= aux_buffers[i][j].geometry;
                     aux_buffer_current_scale[i][j] = 1.0;
+                    aux_buffer_skipped_frames[i][j] = 0;
+                    aux_buffer_use_thumbnail[i][j] = true;
                 }
             }
         }
@@ -510,7 +676,7 @@ class workspace_wall_t : public wf::signal::provider_t
             {
                 for (auto& [_, buffer] : buffers)
                 {
-                    buffer.release();
+                    wf::get_framebuffer_pool().release(buffer);
                 }
             }
 
@@ -550,6 +716,38 @@ class workspace_wall_t : public wf::signal::provider_t
         per_workspace_map_t<wf::region_t> aux_buffer_damage;
         // Current rendering scale for the workspace
         per_workspace_map_t<float> aux_buffer_current_scale;
+        // Number of frames for which the buffer was not updated due to the update budget
+        per_workspace_map_t<int> aux_buffer_skipped_frames;
+        // Whether the cached thumbnail is shown until the buffer is rendered for the first time
+        per_workspace_map_t<bool> aux_buffer_use_thumbnail;
+
+        /**
+         * Get the cached thumbnail of the workspace if it is still shown instead of the buffer.
+         * The thumbnail is owned by the cache, which may drop or update it at any time, so it is looked up
+         * anew every time.
+         */
+        const workspace_thumbnail_t *get_thumbnail(int i, int j)
+        {
+            if (!aux_buffer_use_thumbnail[i][j])
+            {
+                return nullptr;
+            }
+
+            auto cache = workspace_thumbnail_cache_t::get_if_active();
+            auto thumb = cache ? cache->get_thumbnail(wall->output, {i, j}) : nullptr;
+            if (!thumb)
+            {
+                // Not available anymore, render the workspace live from now on.
+                aux_buffer_use_thumbnail[i][j] = false;
+            }
+
+            return thumb;
+        }
+
+        bool has_thumbnail(int i, int j)
+        {
+            return get_thumbnail(i, j) != nullptr;
+        }
     };
     std::shared_ptr<workspace_wall_node_t> render_node;
 };
@@ -2,6 +2,7 @@
 #include <memory>
 #include <wayfire/plugin.hpp>
 #include <wayfire/opengl.hpp>
+#include <wayfire/framebuffer-pool.hpp>
 #include <wayfire/output.hpp>
 #include <wayfire/core.hpp>
 #include <wayfire/workspace-stream.hpp>
@@ -86,7 +87,7 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
                 OpenGL::render_begin();
                 for (auto& buf : framebuffers)
                 {
-                    buf.release();
+                    wf::get_framebuffer_pool().release(buf);
                 }
 
                 OpenGL::render_end();
@@ -120,7 +121,7 @@ class wayfire_cube : public wf::per_output_plugin_instance_t, public wf::pointer
 
                     auto size = framebuffers[i].framebuffer_box_from_geometry_box(framebuffers[i].geometry);
                     OpenGL::render_begin();
-                    framebuffers[i].allocate(size.width, size.height);
+                    wf::get_framebuffer_pool().allocate(framebuffers[i], size.width, size.height);
                     OpenGL::render_end();
 
                     wf::scene::render_pass_params_t params;
@@ -4,6 +4,7 @@
 #include <config.h>
 #include <wayfire/core.hpp>
 #include <wayfire/img.hpp>
+#include <wayfire/gpu-resources.hpp>
 
 #include "cubemap-shaders.tpp"
 
@@ -17,6 +18,7 @@ wf_cube_background_cubemap::~wf_cube_background_cubemap()
 {
     OpenGL::render_begin();
     program.free_resources();
+    wf::gpu_resources::untrack_texture(tex);
     GL_CALL(glDeleteTextures(1, &tex));
     GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
     GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
@@ -38,8 +40,19 @@ void wf_cube_background_cubemap::reload_texture()
         return;
     }
 
+    // Decode the image in the background, the previous texture (if any) is used until then.
     last_background_image = background_image;
+    pending_image = image_io::decode_file_async(last_background_image,
+        [=] (std::shared_ptr<const image_io::decoded_image_t> image)
+    {
+        pending_image.reset();
+        upload_texture(image);
+    });
+}
 
+void wf_cube_background_cubemap::upload_texture(
+    std::shared_ptr<const image_io::decoded_image_t> image)
+{
     OpenGL::render_begin();
     if (tex == (uint32_t)-1)
     {
@@ -49,11 +62,12 @@ void wf_cube_background_cubemap::reload_texture()
     }
 
     GL_CALL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex));
-    if (!image_io::load_from_file(last_background_image, GL_TEXTURE_CUBE_MAP))
+    if (!image || !image_io::upload_to_texture(*image, GL_TEXTURE_CUBE_MAP))
     {
         LOGE("Failed to load cubemap background image from \"%s\".",
             last_background_image.c_str());
 
+        wf::gpu_resources::untrack_texture(tex);
         GL_CALL(glDeleteTextures(1, &tex));
         GL_CALL(glDeleteBuffers(1, &vbo_cube_vertices));
         GL_CALL(glDeleteBuffers(1, &ibo_cube_indices));
@@ -86,8 +100,15 @@ void wf_cube_background_cubemap::render_frame(const wf::render_target_t& fb,
     OpenGL::render_begin(fb);
     if (tex == (uint32_t)-1)
     {
-        GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
-        GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+        if (pending_image)
+        {
+            OpenGL::clear(background_color, GL_COLOR_BUFFER_BIT);
+        } else
+        {
+            GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
+            GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+        }
+
         OpenGL::render_end();
 
         return;
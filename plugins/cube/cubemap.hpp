@@ -2,6 +2,7 @@
 #define WF_CUBE_CUBEMAP_HPP
 
 #include "cube-background.hpp"
+#include <wayfire/img.hpp>
 
 class wf_cube_background_cubemap : public wf_cube_background_base
 {
@@ -14,15 +15,19 @@ class wf_cube_background_cubemap : public wf_cube_background_base
 
   private:
     void reload_texture();
+    void upload_texture(std::shared_ptr<const image_io::decoded_image_t> image);
     void create_program();
 
     OpenGL::program_t program;
     GLuint tex = -1;
+    std::shared_ptr<image_io::decode_request_t> pending_image;
     GLuint vbo_cube_vertices;
     GLuint ibo_cube_indices;
 
     std::string last_background_image;
     wf::option_wrapper_t<std::string> background_image{"cube/cubemap_image"};
+    // Shown while the first image is being decoded
+    wf::option_wrapper_t<wf::color_t> background_color{"cube/background"};
 };
 
 #endif /* end of include guard: WF_CUBE_CUBEMAP_HPP */
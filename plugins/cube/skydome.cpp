@@ -1,6 +1,7 @@
 #include "skydome.hpp"
 #include <wayfire/core.hpp>
 #include <wayfire/img.hpp>
+#include <wayfire/gpu-resources.hpp>
 
 #include <wayfire/output.hpp>
 #include <wayfire/workspace-set.hpp>
@@ -25,6 +26,7 @@ wf_cube_background_skydome::~wf_cube_background_skydome()
     program.free_resources();
     if (tex != (GLuint) - 1)
     {
+        wf::gpu_resources::untrack_texture(tex);
         GL_CALL(glDeleteTextures(1, &tex));
     }
 
@@ -45,7 +47,19 @@ void wf_cube_background_skydome::reload_texture()
         return;
     }
 
+    // Decode the image in the background, the previous texture (if any) is used until then.
     last_background_image = background_image;
+    pending_image = image_io::decode_file_async(last_background_image,
+        [=] (std::shared_ptr<const image_io::decoded_image_t> image)
+    {
+        pending_image.reset();
+        upload_texture(image);
+    });
+}
+
+void wf_cube_background_skydome::upload_texture(
+    std::shared_ptr<const image_io::decoded_image_t> image)
+{
     OpenGL::render_begin();
 
     if (tex == (uint32_t)-1)
@@ -55,7 +69,7 @@ void wf_cube_background_skydome::reload_texture()
 
     GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
 
-    if (image_io::load_from_file(last_background_image, GL_TEXTURE_2D))
+    if (image && image_io::upload_to_texture(*image, GL_TEXTURE_2D))
     {
         GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
         GL_CALL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
@@ -65,6 +79,7 @@ void wf_cube_background_skydome::reload_texture()
     {
         LOGE("Failed to load skydome image from \"%s\".",
             last_background_image.c_str());
+        wf::gpu_resources::untrack_texture(tex);
         GL_CALL(glDeleteTextures(1, &tex));
         tex = -1;
     }
@@ -137,8 +152,14 @@ void wf_cube_background_skydome::render_frame(const wf::render_target_t& fb,
 
     if (tex == (uint32_t)-1)
     {
-        GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
-        GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+        if (pending_image)
+        {
+            OpenGL::clear(background_color, GL_COLOR_BUFFER_BIT);
+        } else
+        {
+            GL_CALL(glClearColor(TEX_ERROR_FLAG_COLOR));
+            GL_CALL(glClear(GL_COLOR_BUFFER_BIT));
+        }
 
         return;
     }
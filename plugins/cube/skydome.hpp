@@ -3,6 +3,7 @@
 
 #include "cube-background.hpp"
 #include "wayfire/output.hpp"
+#include <wayfire/img.hpp>
 #include <vector>
 
 class wf_cube_background_skydome : public wf_cube_background_base
@@ -20,9 +21,11 @@ class wf_cube_background_skydome : public wf_cube_background_base
     void load_program();
     void fill_vertices();
     void reload_texture();
+    void upload_texture(std::shared_ptr<const image_io::decoded_image_t> image);
 
     OpenGL::program_t program;
     GLuint tex = -1;
+    std::shared_ptr<image_io::decode_request_t> pending_image;
 
     std::vector<GLfloat> vertices;
     std::vector<GLfloat> coords;
@@ -32,6 +35,8 @@ class wf_cube_background_skydome : public wf_cube_background_base
     int last_mirror = -1;
     wf::option_wrapper_t<std::string> background_image{"cube/skydome_texture"};
     wf::option_wrapper_t<bool> mirror_opt{"cube/skydome_mirror"};
+    // Shown while the first image is being decoded
+    wf::option_wrapper_t<wf::color_t> background_color{"cube/background"};
 };
 
 #endif /* end of include guard: WF_CUBE_BACKGROUND_SKYDOME */
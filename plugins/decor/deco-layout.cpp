@@ -73,7 +73,7 @@ decoration_layout_t::decoration_layout_t(const decoration_theme_t& th,
 
 wf::geometry_t decoration_layout_t::create_buttons(int width, int)
 {
-    std::stringstream stream((std::string)button_order);
+    std::stringstream stream(theme.get_button_order());
     std::vector<button_type_t> buttons;
     std::string button_name;
     while (stream >> button_name)
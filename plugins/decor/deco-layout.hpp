@@ -174,7 +174,6 @@ class decoration_layout_t
 
     /** Unset hover state of hovered button at @position, if any */
     void unset_hover(std::optional<wf::point_t> position);
-    wf::option_wrapper_t<std::string> button_order{"decoration/button_order"};
 };
 }
 }
@@ -34,6 +34,7 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
     wf::signal::connection_t<wf::view_title_changed_signal> title_set =
         [=] (wf::view_title_changed_signal *ev)
     {
+        titlebar_cache.dirty = true;
         if (auto view = _view.lock())
         {
             view->damage();
@@ -63,6 +64,72 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
         std::string current_text = "";
     } title_texture;
 
+    /**
+     * The titlebar (the top border, the title and the buttons) is pre-rendered in an offscreen buffer,
+     * so that repainting the decoration only needs a single texture blit. The cached titlebar is
+     * re-rendered only when the width, scale or activated state changes, when the title or a button
+     * changes, or when the theme options change. The left, right and bottom borders are a flat color
+     * and are painted directly.
+     */
+    struct
+    {
+        wf::render_target_t buffer;
+        bool activated = false;
+        bool dirty     = true;
+    } titlebar_cache;
+
+    bool is_activated()
+    {
+        auto view = _view.lock();
+        return view && view->activated;
+    }
+
+    /**
+     * Re-render the cached titlebar if it is out of date. This switches to the offscreen buffer, so it
+     * is done while scheduling the render instructions, before the target is rendered to.
+     */
+    void update_titlebar_cache(float scale, bool activated)
+    {
+        auto& cache = titlebar_cache;
+        const wf::geometry_t strip = {0, 0, size.width, current_titlebar};
+        if (!cache.dirty && (cache.activated == activated) && (cache.buffer.scale == scale) &&
+            (cache.buffer.geometry == strip))
+        {
+            return;
+        }
+
+        cache.dirty     = false;
+        cache.activated = activated;
+        cache.buffer.geometry = strip;
+        cache.buffer.scale    = scale;
+        cache.buffer.wl_transform = WL_OUTPUT_TRANSFORM_NORMAL;
+        cache.buffer.transform    = get_output_matrix_from_transform(cache.buffer.wl_transform);
+
+        auto fb_size = cache.buffer.framebuffer_box_from_geometry_box(strip);
+        OpenGL::render_begin();
+        cache.buffer.allocate(std::max(fb_size.width, 1), std::max(fb_size.height, 1));
+        OpenGL::render_end();
+
+        OpenGL::render_begin(cache.buffer);
+        OpenGL::clear({0, 0, 0, 0});
+        OpenGL::render_end();
+
+        theme.render_background(cache.buffer, strip, strip, activated);
+        for (auto item : layout.get_renderable_areas())
+        {
+            if (item->get_type() == wf::decor::DECORATION_AREA_TITLE)
+            {
+                OpenGL::render_begin(cache.buffer);
+                cache.buffer.logic_scissor(strip);
+                render_title(cache.buffer, item->get_geometry());
+                OpenGL::render_end();
+            } else // button
+            {
+                item->as_button().render(cache.buffer, item->get_geometry(), strip);
+            }
+        }
+    }
+
   public:
     wf::decor::decoration_theme_t theme;
     wf::decor::decoration_layout_t layout;
@@ -76,9 +143,22 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
     simple_decoration_node_t(wayfire_toplevel_view view) :
         node_t(false),
         theme{},
-        layout{theme, [=] (wlr_box box) { wf::scene::damage_node(shared_from_this(), box + get_offset()); }}
+        layout{theme, [=] (wlr_box box)
+    {
+        titlebar_cache.dirty = true;
+        wf::scene::damage_node(shared_from_this(), box + get_offset());
+    }}
     {
         this->_view = view->weak_from_this();
+        theme.set_changed_callback([=] ()
+        {
+            titlebar_cache.dirty = true;
+            title_texture.current_text.clear();
+            // The button order may have changed
+            layout.resize(size.width, size.height);
+            update_decoration_size();
+            wf::scene::damage_node(shared_from_this(), get_bounding_box());
+        });
         view->connect(&title_set);
         if (view->parent)
         {
@@ -94,6 +174,13 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
         update_decoration_size();
     }
 
+    ~simple_decoration_node_t()
+    {
+        OpenGL::render_begin();
+        titlebar_cache.buffer.release();
+        OpenGL::render_end();
+    }
+
     wf::point_t get_offset()
     {
         return {-current_thickness, -current_titlebar};
@@ -110,33 +197,18 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
     void render_scissor_box(const wf::render_target_t& fb, wf::point_t origin,
         const wlr_box& scissor)
     {
-        /* Clear background */
-        wlr_box geometry{origin.x, origin.y, size.width, size.height};
-
-        bool activated = false;
-        if (auto view = _view.lock())
-        {
-            activated = view->activated;
-        }
-
-        theme.render_background(fb, geometry, scissor, activated);
-
-        /* Draw title & buttons */
-        auto renderables = layout.get_renderable_areas();
-        for (auto item : renderables)
-        {
-            if (item->get_type() == wf::decor::DECORATION_AREA_TITLE)
-            {
-                OpenGL::render_begin(fb);
-                fb.logic_scissor(scissor);
-                render_title(fb, item->get_geometry() + origin);
-                OpenGL::render_end();
-            } else // button
-            {
-                item->as_button().render(fb,
-                    item->get_geometry() + origin, scissor);
-            }
-        }
+        bool activated = is_activated();
+
+        /* Side and bottom borders */
+        wlr_box borders{origin.x, origin.y + current_titlebar, size.width, size.height - current_titlebar};
+        theme.render_background(fb, borders, scissor, activated);
+
+        /* Titlebar, title & buttons */
+        OpenGL::render_begin(fb);
+        fb.logic_scissor(scissor);
+        OpenGL::render_texture(wf::texture_t{titlebar_cache.buffer.tex}, fb,
+            titlebar_cache.buffer.geometry + origin, glm::vec4(1.0f));
+        OpenGL::render_end();
     }
 
     std::optional<wf::scene::input_node_t> find_node_at(const wf::pointf_t& at) override
@@ -192,6 +264,7 @@ class simple_decoration_node_t : public wf::scene::node_t, public wf::pointer_in
             wf::region_t our_damage = damage & our_region;
             if (!our_damage.empty())
             {
+                self->update_titlebar_cache(target.scale, self->is_activated());
                 instructions.push_back(wf::scene::render_instruction_t{
                     .instance = this,
                     .target   = target,
@@ -24,12 +24,28 @@ int decoration_theme_t::get_border_size() const
     return border_size;
 }
 
+/** @return The order of the buttons, as a space-separated list of button names */
+std::string decoration_theme_t::get_button_order() const
+{
+    return button_order;
+}
+
 /** @return The available border for resizing */
 void decoration_theme_t::set_buttons(button_type_t flags)
 {
     button_flags = flags;
 }
 
+void decoration_theme_t::set_changed_callback(std::function<void()> callback)
+{
+    font.set_callback(callback);
+    title_height.set_callback(callback);
+    border_size.set_callback(callback);
+    active_color.set_callback(callback);
+    inactive_color.set_callback(callback);
+    button_order.set_callback(callback);
+}
+
 /**
  * Fill the given rectangle with the background color(s).
  *
@@ -20,6 +20,8 @@ class decoration_theme_t
     int get_title_height() const;
     /** @return The available border for resizing */
     int get_border_size() const;
+    /** @return The order of the buttons, as a space-separated list of button names */
+    std::string get_button_order() const;
     /** Set the flags for buttons */
     void set_buttons(button_type_t flags);
     button_type_t button_flags;
@@ -64,12 +66,19 @@ class decoration_theme_t
     cairo_surface_t *get_button_surface(button_type_t button,
         const button_state_t& state) const;
 
+    /**
+     * Set a callback which is executed whenever one of the options which
+     * affect the look of the decoration changes.
+     */
+    void set_changed_callback(std::function<void()> callback);
+
   private:
     wf::option_wrapper_t<std::string> font{"decoration/font"};
     wf::option_wrapper_t<int> title_height{"decoration/title_height"};
     wf::option_wrapper_t<int> border_size{"decoration/border_size"};
     wf::option_wrapper_t<wf::color_t> active_color{"decoration/active_color"};
     wf::option_wrapper_t<wf::color_t> inactive_color{"decoration/inactive_color"};
+    wf::option_wrapper_t<std::string> button_order{"decoration/button_order"};
 };
 }
 }
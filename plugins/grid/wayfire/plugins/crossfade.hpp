@@ -56,7 +56,7 @@ class crossfade_node_t : public scene::view_2d_transformer_t
         OpenGL::render_begin();
         auto w = original_buffer.scale * original_buffer.geometry.width;
         auto h = original_buffer.scale * original_buffer.geometry.height;
-        original_buffer.allocate(w, h);
+        wf::get_framebuffer_pool().allocate(original_buffer, w, h);
         OpenGL::render_end();
 
         std::vector<scene::render_instance_uptr> instances;
@@ -73,7 +73,7 @@ class crossfade_node_t : public scene::view_2d_transformer_t
     ~crossfade_node_t()
     {
         OpenGL::render_begin();
-        original_buffer.release();
+        wf::get_framebuffer_pool().release(original_buffer);
         OpenGL::render_end();
     }
 
@@ -14,12 +14,16 @@ class ipc_rules_input_methods_t
     {
         method_repository->register_method("input/list-devices", list_input_devices);
         method_repository->register_method("input/configure-device", configure_input_device);
+        method_repository->register_method("input/latency", get_input_latency);
+        method_repository->register_method("input/reset-latency", reset_input_latency);
     }
 
     void fini_input_methods(ipc::method_repository_t *method_repository)
     {
         method_repository->unregister_method("input/list-devices");
         method_repository->unregister_method("input/configure-device");
+        method_repository->unregister_method("input/latency");
+        method_repository->unregister_method("input/reset-latency");
     }
 
     static std::string wlr_input_device_type_to_string(wlr_input_device_type type)
@@ -84,5 +88,49 @@ class ipc_rules_input_methods_t
 
         return wf::ipc::json_error("Unknown input device!");
     };
+
+    wf::ipc::method_callback get_input_latency = [&] (const nlohmann::json&)
+    {
+        auto response = nlohmann::json::array();
+        for (auto& device : wf::get_core().get_input_devices())
+        {
+            auto& histogram = device->get_latency_histogram();
+
+            nlohmann::json d;
+            d["id"]    = (intptr_t)device->get_wlr_handle();
+            d["name"]  = nonull(device->get_wlr_handle()->name);
+            d["count"] = histogram.count;
+            d["min_us"]  = histogram.min_us;
+            d["max_us"]  = histogram.max_us;
+            d["mean_us"] = histogram.count ? histogram.total_us / (int64_t)histogram.count : 0;
+
+            d["buckets"] = nlohmann::json::array();
+            for (size_t i = 0; i < histogram.buckets.size(); i++)
+            {
+                nlohmann::json bucket;
+                if (i < histogram.bucket_bounds_us.size())
+                {
+                    bucket["max_us"] = histogram.bucket_bounds_us[i];
+                }
+
+                bucket["count"] = histogram.buckets[i];
+                d["buckets"].push_back(bucket);
+            }
+
+            response.push_back(d);
+        }
+
+        return response;
+    };
+
+    wf::ipc::method_callback reset_input_latency = [&] (const nlohmann::json&)
+    {
+        for (auto& device : wf::get_core().get_input_devices())
+        {
+            device->get_latency_histogram() = {};
+        }
+
+        return wf::ipc::json_ok();
+    };
 };
 }
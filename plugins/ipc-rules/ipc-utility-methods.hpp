@@ -3,11 +3,15 @@
 #include "ipc-rules-common.hpp"
 #include "plugins/ipc/ipc-method-repository.hpp"
 #include "wayfire/debug.hpp"
+#include <map>
 #include <set>
 #include <wayfire/plugin.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include <wayfire/output-layout.hpp>
 #include <wayfire/config/compound-option.hpp>
+#include <wayfire/framebuffer-pool.hpp>
+#include <wayfire/gpu-resources.hpp>
+#include <wayfire/unstable/xwl-toplevel-base.hpp>
 
 extern "C" {
 #include <wlr/backend/headless.h>
@@ -30,6 +34,8 @@ class ipc_rules_utility_methods_t
         method_repository->register_method("wayfire/destroy-headless-output", destroy_headless_output);
         method_repository->register_method("wayfire/get-config-option", get_config_option);
         method_repository->register_method("wayfire/set-config-options", set_config_options);
+        method_repository->register_method("wayfire/gpu-resources", get_gpu_resources);
+        method_repository->register_method("wayfire/xwayland-configure-stats", get_xwayland_configure_stats);
     }
 
     void fini_utility_methods(ipc::method_repository_t *method_repository)
@@ -39,6 +45,8 @@ class ipc_rules_utility_methods_t
         method_repository->unregister_method("wayfire/destroy-headless-output");
         method_repository->unregister_method("wayfire/get-config-option");
         method_repository->unregister_method("wayfire/set-config-option");
+        method_repository->unregister_method("wayfire/gpu-resources");
+        method_repository->unregister_method("wayfire/xwayland-configure-stats");
     }
 
     wf::ipc::method_callback get_wayfire_configuration_info = [=] (nlohmann::json)
@@ -243,6 +251,7 @@ class ipc_rules_utility_methods_t
             return wf::ipc::json_error("Options must be an object!");
         }
 
+        reload_config_signal event;
         for (auto& [option, value] : data.items())
         {
             auto opt = wf::get_core().config.get_option(option);
@@ -268,11 +277,125 @@ class ipc_rules_utility_methods_t
             }
 
             opt->set_locked(true);
+            event.changed_sections.insert(option.substr(0, option.rfind('/')));
         }
 
-        reload_config_signal event;
         wf::get_core().emit(&event);
         return wf::ipc::json_ok();
     };
+
+    /**
+     * Summarize the GPU resources held by each module. With "details": true, all resources are listed.
+     */
+    wf::ipc::method_callback get_gpu_resources = [=] (const nlohmann::json& data)
+    {
+        WFJSON_OPTIONAL_FIELD(data, "details", boolean);
+
+        auto response = wf::ipc::json_ok();
+        response["resources"] = nlohmann::json::array();
+
+        struct usage_t
+        {
+            int textures     = 0;
+            int framebuffers = 0;
+            size_t bytes     = 0;
+        };
+
+        std::map<std::string, usage_t> owners;
+        size_t total_bytes = 0;
+        for (auto& res : wf::gpu_resources::get_resources())
+        {
+            const bool is_texture = (res.type == wf::gpu_resources::resource_type_t::TEXTURE);
+            auto& usage = owners[res.owner];
+            (is_texture ? usage.textures : usage.framebuffers)++;
+            usage.bytes += res.bytes;
+            total_bytes += res.bytes;
+
+            if (data.value("details", false))
+            {
+                nlohmann::json r;
+                r["type"]   = is_texture ? "texture" : "framebuffer";
+                r["id"]     = res.id;
+                r["width"]  = res.width;
+                r["height"] = res.height;
+                r["bytes"]  = res.bytes;
+                r["owner"]  = res.owner;
+                response["resources"].push_back(r);
+            }
+        }
+
+        response["owners"] = nlohmann::json::array();
+        for (auto& [name, usage] : owners)
+        {
+            nlohmann::json owner;
+            owner["owner"]    = name;
+            owner["textures"] = usage.textures;
+            owner["framebuffers"] = usage.framebuffers;
+            owner["bytes"] = usage.bytes;
+            response["owners"].push_back(owner);
+        }
+
+        response["total-bytes"] = total_bytes;
+
+        auto pool = wf::get_framebuffer_pool().get_stats();
+        response["framebuffer-pool"]["used-buffers"] = pool.used_buffers;
+        response["framebuffer-pool"]["used-bytes"]   = pool.used_bytes;
+        response["framebuffer-pool"]["idle-buffers"] = pool.idle_buffers;
+        response["framebuffer-pool"]["idle-bytes"]   = pool.idle_bytes;
+        response["framebuffer-pool"]["reused"]  = pool.reused;
+        response["framebuffer-pool"]["created"] = pool.created;
+        return response;
+    };
+
+    /**
+     * Report how many configure requests of Xwayland views were coalesced, in total and for each view which
+     * sent configure requests. With "reset": true, the counters are reset afterwards.
+     */
+    wf::ipc::method_callback get_xwayland_configure_stats = [=] (const nlohmann::json& data)
+    {
+        WFJSON_OPTIONAL_FIELD(data, "reset", boolean);
+
+        auto response = wf::ipc::json_ok();
+        response["views"] = nlohmann::json::array();
+#if WF_HAS_XWAYLAND
+        auto stats_to_json = [] (const wf::xwayland_configure_stats_t& stats)
+        {
+            nlohmann::json j;
+            j["requests"]  = stats.requests;
+            j["coalesced"] = stats.coalesced;
+            j["coalesced-batches"] = stats.coalesced_batches;
+            return j;
+        };
+
+        const bool reset = data.value("reset", false);
+        for (auto& view : wf::get_core().get_all_views())
+        {
+            auto xwayland_view = dynamic_cast<wf::xwayland_view_base_t*>(view.get());
+            if (!xwayland_view || (xwayland_view->get_configure_stats().requests == 0))
+            {
+                continue;
+            }
+
+            auto v = stats_to_json(xwayland_view->get_configure_stats());
+            v["id"]     = view->get_id();
+            v["app-id"] = view->get_app_id();
+            response["views"].push_back(v);
+            if (reset)
+            {
+                xwayland_view->get_configure_stats() = {};
+            }
+        }
+
+        response["total"] = stats_to_json(wf::xwayland_view_base_t::get_total_configure_stats());
+        if (reset)
+        {
+            wf::xwayland_view_base_t::get_total_configure_stats() = {};
+        }
+
+#else
+        response["total"] = {{"requests", 0}, {"coalesced", 0}, {"coalesced-batches", 0}};
+#endif
+        return response;
+    };
 };
 }
@@ -15,15 +15,7 @@ namespace ipc
 {
 inline wayfire_view find_view_by_id(uint32_t id)
 {
-    for (auto view : wf::get_core().get_all_views())
-    {
-        if (view->get_id() == id)
-        {
-            return view;
-        }
-    }
-
-    return nullptr;
+    return wf::tracking_allocator_t<wf::view_interface_t>::get().find_by_id(id);
 }
 
 inline wf::output_t *find_output_by_id(int32_t id)
@@ -41,7 +33,8 @@ inline wf::output_t *find_output_by_id(int32_t id)
 
 inline wf::workspace_set_t *find_workspace_set_by_index(int32_t index)
 {
-    for (auto wset : wf::workspace_set_t::get_all())
+    // There are only a few workspace sets, but avoid copying the list.
+    for (auto& wset : wf::tracking_allocator_t<wf::workspace_set_t>::get().get_all())
     {
         if ((int)wset->get_index() == index)
         {
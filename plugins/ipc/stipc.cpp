@@ -314,7 +314,6 @@ class stipc_plugin_t : public wf::plugin_interface_t
 
     ipc::method_callback layout_views = [] (nlohmann::json data)
     {
-        auto views = wf::get_core().get_all_views();
         WFJSON_EXPECT_FIELD(data, "views", array);
         for (auto v : data["views"])
         {
@@ -324,18 +323,14 @@ class stipc_plugin_t : public wf::plugin_interface_t
             WFJSON_EXPECT_FIELD(v, "width", number);
             WFJSON_EXPECT_FIELD(v, "height", number);
 
-            auto it = std::find_if(views.begin(), views.end(), [&] (auto& view)
-            {
-                return view->get_id() == v["id"];
-            });
-
-            if (it == views.end())
+            auto view = wf::tracking_allocator_t<wf::view_interface_t>::get().find_by_id(v["id"]);
+            if (!view)
             {
                 return wf::ipc::json_error("Could not find view with id " +
                     std::to_string((int)v["id"]));
             }
 
-            auto toplevel = toplevel_cast(*it);
+            auto toplevel = toplevel_cast(view);
             if (!toplevel)
             {
                 return wf::ipc::json_error("View is not toplevel view id " +
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace wf
+{
+/**
+ * A search index over the titles and app-ids of the views shown in a scale session.
+ *
+ * The normalized (i.e. lower-cased if matching is case insensitive) strings are computed once per view and
+ * kept until the view's title or app-id changes. The matches for each prefix of the current filter are
+ * remembered as well: typing another character only checks the views which matched before, and removing a
+ * character simply goes back to the previous results.
+ *
+ * Entries are identified by the id of the view (see wf::object_base_t::get_id()).
+ */
+class title_filter_index_t
+{
+  public:
+    /**
+     * Set how strings are matched. Changing any of the settings clears the index.
+     *
+     * @param case_sensitive Whether to match the case of ASCII letters.
+     * @param fuzzy Whether the characters of the filter only need to appear in order, instead of as a
+     *   substring. Fuzzy matches are also ranked, see get_score().
+     */
+    void configure(bool case_sensitive, bool fuzzy)
+    {
+        if ((case_sensitive != this->case_sensitive) || (fuzzy != this->fuzzy))
+        {
+            this->case_sensitive = case_sensitive;
+            this->fuzzy = fuzzy;
+            clear();
+        }
+    }
+
+    bool contains(uint32_t id) const
+    {
+        return entries.count(id);
+    }
+
+    /**
+     * Add an entry to the index, or update its strings if it is already in the index.
+     */
+    void set_entry(uint32_t id, std::string title, std::string app_id)
+    {
+        auto& entry = entries[id];
+        entry.title  = normalize(std::move(title));
+        entry.app_id = normalize(std::move(app_id));
+
+        // Find out up to which prefix of the filter the entry matches now.
+        bool matched = true;
+        for (auto& level : levels)
+        {
+            level.matches.erase(id);
+            int score = matched ? match(entry, level.filter) : -1;
+            matched = (score >= 0);
+            if (matched)
+            {
+                level.matches[id] = score;
+            }
+        }
+    }
+
+    void remove_entry(uint32_t id)
+    {
+        entries.erase(id);
+        for (auto& level : levels)
+        {
+            level.matches.erase(id);
+        }
+    }
+
+    void clear()
+    {
+        entries.clear();
+        levels.clear();
+    }
+
+    /**
+     * Set the filter which entries are matched against.
+     */
+    void set_filter(std::string filter)
+    {
+        filter = normalize(std::move(filter));
+
+        // Go back to the longest filter we already have results for which is a prefix of the new one.
+        while (!levels.empty() && (filter.compare(0, levels.back().filter.size(), levels.back().filter) != 0))
+        {
+            levels.pop_back();
+        }
+
+        if (filter.empty() || (!levels.empty() && (levels.back().filter == filter)))
+        {
+            return;
+        }
+
+        level_t level;
+        level.filter = filter;
+        auto try_entry = [&] (uint32_t id, const entry_t& entry)
+        {
+            int score = match(entry, filter);
+            if (score >= 0)
+            {
+                level.matches[id] = score;
+            }
+        };
+
+        if (levels.empty())
+        {
+            for (auto& [id, entry] : entries)
+            {
+                try_entry(id, entry);
+            }
+        } else
+        {
+            for (auto& [id, _] : levels.back().matches)
+            {
+                try_entry(id, entries.at(id));
+            }
+        }
+
+        levels.push_back(std::move(level));
+    }
+
+    /**
+     * @return Whether the entry matches the current filter. All entries match the empty filter.
+     */
+    bool matches(uint32_t id) const
+    {
+        if (levels.empty())
+        {
+            return entries.count(id);
+        }
+
+        return levels.back().matches.count(id);
+    }
+
+    /**
+     * @return How well the entry matches the current filter, higher is better, or -1 if it does not match.
+     *   Without fuzzy matching, all matching entries have the same score.
+     */
+    int get_score(uint32_t id) const
+    {
+        if (levels.empty())
+        {
+            return entries.count(id) ? 0 : -1;
+        }
+
+        auto it = levels.back().matches.find(id);
+        return (it == levels.back().matches.end()) ? -1 : it->second;
+    }
+
+    /**
+     * Score how well @text matches @pattern as a subsequence: each character scores a point, with bonuses for
+     * characters following the previous match and for characters at the start of a word.
+     *
+     * Both strings are UTF-8, a multi-byte character in the pattern has to match as a whole.
+     *
+     * @return The score, or -1 if the characters of @pattern do not appear in @text in order.
+     */
+    static int fuzzy_score(const std::string& text, const std::string& pattern)
+    {
+        static constexpr int CONSECUTIVE_BONUS = 4;
+        static constexpr int WORD_START_BONUS  = 6;
+        static constexpr int MAX_GAP_PENALTY   = 3;
+
+        int score = 0;
+        size_t pos = 0;
+        size_t last_match = std::string::npos;
+        for (size_t i = 0; i < pattern.size();)
+        {
+            size_t len = std::min(utf8_char_length(pattern[i]), pattern.size() - i);
+            pos = text.find(pattern.c_str() + i, pos, len);
+            if (pos == std::string::npos)
+            {
+                return -1;
+            }
+
+            score += 1;
+            if ((last_match != std::string::npos) && (pos == last_match))
+            {
+                score += CONSECUTIVE_BONUS;
+            } else if (last_match != std::string::npos)
+            {
+                score -= std::min((int)(pos - last_match), MAX_GAP_PENALTY);
+            }
+
+            if ((pos == 0) || !std::isalnum((unsigned char)text[pos - 1]))
+            {
+                score += WORD_START_BONUS;
+            }
+
+            pos += len;
+            i   += len;
+            last_match = pos;
+        }
+
+        return std::max(score, 0);
+    }
+
+  private:
+    struct entry_t
+    {
+        std::string title;
+        std::string app_id;
+    };
+
+    struct level_t
+    {
+        std::string filter;
+        /* The entries matching the filter, with their scores. */
+        std::unordered_map<uint32_t, int> matches;
+    };
+
+    bool case_sensitive = false;
+    bool fuzzy = false;
+    std::unordered_map<uint32_t, entry_t> entries;
+    /* The results for successively longer prefixes of the current filter. */
+    std::vector<level_t> levels;
+
+    static size_t utf8_char_length(char lead)
+    {
+        auto c = (unsigned char)lead;
+        if (c >= 0xf0)
+        {
+            return 4;
+        } else if (c >= 0xe0)
+        {
+            return 3;
+        } else if (c >= 0xc0)
+        {
+            return 2;
+        }
+
+        return 1;
+    }
+
+    std::string normalize(std::string string) const
+    {
+        if (case_sensitive)
+        {
+            return string;
+        }
+
+        auto transform = [] (unsigned char c) -> unsigned char
+        {
+            if (std::isspace(c))
+            {
+                return ' ';
+            }
+
+            return (c <= 127) ? (unsigned char)std::tolower(c) : c;
+        };
+        std::transform(string.begin(), string.end(), string.begin(), transform);
+        return string;
+    }
+
+    int match(const entry_t& entry, const std::string& filter) const
+    {
+        if (!fuzzy)
+        {
+            return ((entry.title.find(filter) != std::string::npos) ||
+                (entry.app_id.find(filter) != std::string::npos)) ? 0 : -1;
+        }
+
+        return std::max(fuzzy_score(entry.title, filter), fuzzy_score(entry.app_id, filter));
+    }
+};
+}
@@ -20,6 +20,8 @@
 #include <wayfire/plugins/common/simple-texture.hpp>
 #include <wayfire/plugins/common/key-repeat.hpp>
 
+#include "scale-title-filter-index.hpp"
+
 class scale_title_filter;
 
 /**
@@ -83,43 +85,20 @@ class scale_title_filter : public wf::per_output_plugin_instance_t
     scale_title_filter_text local_filter;
     wf::shared_data::ref_ptr_t<scale_title_filter_text> global_filter;
 
-    inline void fix_case(std::string& string)
-    {
-        if (case_sensitive)
-        {
-            return;
-        }
-
-        auto transform = [] (unsigned char c) -> unsigned char
-        {
-            if (std::isspace(c))
-            {
-                return ' ';
-            }
-
-            return (c <= 127) ? (unsigned char)std::tolower(c) : c;
-        };
-        std::transform(string.begin(), string.end(), string.begin(), transform);
-    }
+    wf::option_wrapper_t<bool> fuzzy{"scale-title-filter/fuzzy"};
+    /* Normalized titles and matches of the views in the current scale session */
+    wf::title_filter_index_t index;
+    /* The filter for which the best match was last focused */
+    std::string last_ranked_filter;
 
     bool should_show_view(wayfire_view view)
     {
-        auto filter = get_active_filter().title_filter;
-
-        if (filter.empty())
-        {
-            return true;
-        }
-
-        auto title  = view->get_title();
-        auto app_id = view->get_app_id();
-
-        fix_case(title);
-        fix_case(app_id);
-        fix_case(filter);
+        return index.matches(view->get_id());
+    }
 
-        return (title.find(filter) != std::string::npos) ||
-               (app_id.find(filter) != std::string::npos);
+    void update_index(wayfire_view view)
+    {
+        index.set_entry(view->get_id(), view->get_title(), view->get_app_id());
     }
 
     scale_title_filter_text& get_active_filter()
@@ -154,16 +133,82 @@ class scale_title_filter : public wf::per_output_plugin_instance_t
         if (!scale_running)
         {
             wf::get_core().connect(&scale_key);
+            wf::get_core().connect(&on_title_changed);
+            wf::get_core().connect(&on_app_id_changed);
+            wf::get_core().connect(&on_view_unmapped);
             scale_running = true;
             update_overlay();
         }
 
+        index.configure(case_sensitive, fuzzy);
+        for (auto& view : ev->views_shown)
+        {
+            if (!index.contains(view->get_id()))
+            {
+                update_index(view);
+            }
+        }
+
+        const auto& filter = get_active_filter().title_filter;
+        index.set_filter(filter);
         scale_filter_views(ev, [this] (wayfire_toplevel_view v)
         {
             return !should_show_view(v);
         });
+
+        // Focus the best match whenever the filter changes, but let the user move the focus afterwards.
+        // A shared filter is typed on the active output, so only focus the match there.
+        bool can_focus = !share_filter || (output == wf::get_core().seat->get_active_output());
+        if (fuzzy && can_focus && !filter.empty() && (filter != last_ranked_filter))
+        {
+            auto best = std::max_element(ev->views_shown.begin(), ev->views_shown.end(),
+                [this] (wayfire_toplevel_view a, wayfire_toplevel_view b)
+            {
+                return index.get_score(a->get_id()) < index.get_score(b->get_id());
+            });
+
+            if (best != ev->views_shown.end())
+            {
+                ev->preferred_view = *best;
+            }
+        }
+
+        last_ranked_filter = filter;
+    };
+
+    wf::signal::connection_t<wf::view_title_changed_signal> on_title_changed =
+        [=] (wf::view_title_changed_signal *ev)
+    {
+        handle_view_strings_changed(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_app_id_changed_signal> on_app_id_changed =
+        [=] (wf::view_app_id_changed_signal *ev)
+    {
+        handle_view_strings_changed(ev->view);
+    };
+
+    wf::signal::connection_t<wf::view_unmapped_signal> on_view_unmapped =
+        [=] (wf::view_unmapped_signal *ev)
+    {
+        index.remove_entry(ev->view->get_id());
     };
 
+    void handle_view_strings_changed(wayfire_view view)
+    {
+        if (!index.contains(view->get_id()))
+        {
+            return;
+        }
+
+        bool was_shown = should_show_view(view);
+        update_index(view);
+        if (should_show_view(view) != was_shown)
+        {
+            update_filter();
+        }
+    }
+
     std::map<uint32_t, std::unique_ptr<wf::key_repeat_t>> keys;
     wf::key_repeat_t::callback_t handle_key_repeat = [=] (uint32_t raw_keycode)
     {
@@ -237,7 +282,12 @@ class scale_title_filter : public wf::per_output_plugin_instance_t
     void do_end_scale()
     {
         scale_key.disconnect();
+        on_title_changed.disconnect();
+        on_app_id_changed.disconnect();
+        on_view_unmapped.disconnect();
         keys.clear();
+        index.clear();
+        last_ranked_filter.clear();
         clear_overlay();
         scale_running = false;
         get_active_filter().check_scale_end();
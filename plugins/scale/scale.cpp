@@ -908,6 +908,13 @@ class wayfire_scale : public wf::per_output_plugin_instance_t,
             }
         }
 
+        if (signal.preferred_view && (signal.preferred_view != current_focus_view) &&
+            (std::find(views.begin(), views.end(), signal.preferred_view) != views.end()))
+        {
+            current_focus_view = signal.preferred_view;
+            wf::get_core().default_wm->focus_raise_view(current_focus_view);
+        }
+
         if (!current_focus_view)
         {
             std::sort(views.begin(), views.end(), [=] (wayfire_toplevel_view a, wayfire_toplevel_view b)
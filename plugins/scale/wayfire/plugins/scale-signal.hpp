@@ -25,11 +25,15 @@
  * expect views_hidden to be empty (and should not call clear() on it). It is OK
  * for a plugin to move a view from views_hidden to views_shown, but this will
  * likely not have predictable results.
+ *
+ * A plugin can also set preferred_view to one of the views in views_shown to
+ * ask scale to focus it, for example the best match of a search.
  */
 struct scale_filter_signal
 {
     std::vector<wayfire_toplevel_view>& views_shown;
     std::vector<wayfire_toplevel_view>& views_hidden;
+    wayfire_toplevel_view preferred_view = nullptr;
     scale_filter_signal(std::vector<wayfire_toplevel_view>& shown,
         std::vector<wayfire_toplevel_view>& hidden) : views_shown(shown), views_hidden(hidden)
     {}
@@ -284,9 +284,12 @@ class wayfire_command : public wf::plugin_interface_t
         bindings.clear();
     }
 
-    wf::signal::connection_t<wf::reload_config_signal> on_reload_config = [=] (auto)
+    wf::signal::connection_t<wf::reload_config_signal> on_reload_config = [=] (wf::reload_config_signal *ev)
     {
-        setup_bindings_from_config();
+        if (ev->may_have_changed("command"))
+        {
+            setup_bindings_from_config();
+        }
     };
 
     wf::plugin_activation_data_t grab_interface = {
@@ -14,6 +14,7 @@
 #include <wayfire/debug.hpp>
 
 #include <wayfire/plugins/common/workspace-wall.hpp>
+#include <wayfire/plugins/common/workspace-thumbnail-cache.hpp>
 #include <wayfire/plugins/common/geometry-animation.hpp>
 #include <wayfire/plugins/common/move-drag-interface.hpp>
 #include <wayfire/plugins/common/shared-core-data.hpp>
@@ -42,6 +43,8 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     wf::option_wrapper_t<bool> keyboard_interaction{"expo/keyboard_interaction"};
     wf::option_wrapper_t<double> inactive_brightness{"expo/inactive_brightness"};
     wf::option_wrapper_t<int> transition_length{"expo/transition_length"};
+    wf::option_wrapper_t<int> update_budget{"expo/update_budget"};
+    wf::option_wrapper_t<bool> cache_thumbnails{"expo/cache_thumbnails"};
     wf::geometry_animation_t zoom_animation{zoom_duration};
 
     wf::option_wrapper_t<bool> move_enable_snap_off{"move/enable_snap_off"};
@@ -74,6 +77,20 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     std::vector<std::vector<wf::animation::simple_animation_t>> ws_fade;
     std::unique_ptr<wf::input_grab_t> input_grab;
 
+    /* Keeps the workspace thumbnail cache alive while enabled */
+    std::optional<wf::shared_data::ref_ptr_t<wf::workspace_thumbnail_cache_t>> thumbnail_cache;
+
+    void update_thumbnail_cache()
+    {
+        if (cache_thumbnails && !thumbnail_cache)
+        {
+            thumbnail_cache.emplace();
+        } else if (!cache_thumbnails)
+        {
+            thumbnail_cache.reset();
+        }
+    }
+
   public:
     void setup_workspace_bindings_from_config()
     {
@@ -134,6 +151,9 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
 
         resize_ws_fade();
         output->connect(&on_workspace_grid_changed);
+
+        cache_thumbnails.set_callback([=] () { update_thumbnail_cache(); });
+        update_thumbnail_cache();
     }
 
     bool handle_toggle()
@@ -309,6 +329,7 @@ class wayfire_expo : public wf::per_output_plugin_instance_t, public wf::keyboar
     {
         wall->set_background_color(background_color);
         wall->set_gap_size(this->delimiter_offset);
+        wall->set_update_budget(update_budget);
         if (zoom_in)
         {
             zoom_animation.set_start(wall->get_workspace_rectangle(
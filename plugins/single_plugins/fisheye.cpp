@@ -114,6 +114,12 @@ class wayfire_fisheye : public wf::per_output_plugin_instance_t
     };
 
   public:
+    static constexpr bool can_defer_init()
+    {
+        // Only reacts to bindings.
+        return true;
+    }
+
     void init() override
     {
         hook_set = active = false;
@@ -57,6 +57,12 @@ class wayfire_invert_screen : public wf::per_output_plugin_instance_t
     };
 
   public:
+    static constexpr bool can_defer_init()
+    {
+        // Only reacts to bindings.
+        return true;
+    }
+
     void init() override
     {
         wf::option_wrapper_t<wf::activatorbinding_t> toggle_key{"invert/toggle"};
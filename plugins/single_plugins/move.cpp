@@ -167,6 +167,8 @@ class wayfire_move : public wf::per_output_plugin_instance_t,
 
         input_grab = std::make_unique<wf::input_grab_t>("move", output, nullptr, this, this);
         input_grab->set_wants_raw_input(true);
+        // Moving the view is expensive, do it at most once per frame.
+        input_grab->set_coalesce_pointer_motion(true);
 
         activate_binding = [=] (auto)
         {
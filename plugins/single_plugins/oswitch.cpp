@@ -109,6 +109,12 @@ class wayfire_oswitch : public wf::plugin_interface_t
         bindings->rem_binding(&prev_output_with_window);
         idle_switch_output.disconnect();
     }
+
+    bool can_defer_init() const override
+    {
+        // Only reacts to bindings.
+        return true;
+    }
 };
 
 DECLARE_WAYFIRE_PLUGIN(wayfire_oswitch);
@@ -21,12 +21,14 @@
 
 #include <wayfire/render-manager.hpp>
 #include <wayfire/workspace-set.hpp>
+#include <wayfire/framebuffer-pool.hpp>
 
 #include <wayfire/util/duration.hpp>
 #include <wayfire/nonstd/reverse.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <algorithm>
+#include <map>
 #include <set>
 
 constexpr const char *switcher_transformer = "switcher-3d";
@@ -96,6 +98,25 @@ struct SwitcherView
     }
 };
 
+/**
+ * A reduced-resolution copy of a view's contents, from which the view is rendered while it is shown in the
+ * switcher.
+ */
+struct SwitcherThumbnail
+{
+    wf::render_target_t buffer;
+    /* Render instances of the view's nodes below the switcher transformer */
+    std::vector<wf::scene::render_instance_uptr> instances;
+    /* The part of the buffer which is outdated */
+    wf::region_t damage;
+
+    /* The size of the thumbnail relative to the view, i.e. the largest scale
+     * at which the view can be shown from the thumbnail without losing detail */
+    float view_scale = 1.0;
+    int64_t last_refresh = 0;
+    bool valid = false;
+};
+
 class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyboard_interaction_t
 {
     wf::option_wrapper_t<double> view_thumbnail_scale{
@@ -103,6 +124,8 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     wf::option_wrapper_t<wf::animation_description_t> speed{"switcher/speed"};
     wf::option_wrapper_t<int> view_thumbnail_rotation{
         "switcher/view_thumbnail_rotation"};
+    wf::option_wrapper_t<bool> cache_thumbnails{"switcher/cache_thumbnails"};
+    wf::option_wrapper_t<int> thumbnail_refresh_rate{"switcher/thumbnail_refresh_rate"};
 
     duration_t duration{speed};
     duration_t background_dim_duration{speed};
@@ -113,6 +136,9 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     /* If a view comes before another in this list, it is on top of it */
     std::vector<SwitcherView> views;
 
+    /* Thumbnails of the views shown in the current switcher session */
+    std::map<wayfire_toplevel_view, std::unique_ptr<SwitcherThumbnail>> thumbnails;
+
     // the modifiers which were used to activate switcher
     uint32_t activating_modifiers = 0;
     bool active = false;
@@ -187,6 +213,23 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     };
 
     std::shared_ptr<switcher_render_node_t> render_node;
+
+    wf::signal::connection_t<wf::scene::root_node_update_signal> on_root_update =
+        [=] (wf::scene::root_node_update_signal *ev)
+    {
+        constexpr uint32_t recompute_instances_on = wf::scene::update_flag::CHILDREN_LIST |
+            wf::scene::update_flag::ENABLED;
+        if (!(ev->flags & recompute_instances_on) || (ev->flags & wf::scene::update_flag::MASKED))
+        {
+            return;
+        }
+
+        for (auto& [view, thumb] : thumbnails)
+        {
+            regenerate_thumbnail_instances(view, *thumb);
+        }
+    };
+
     wf::plugin_activation_data_t grab_interface = {
         .name = "switcher",
         .capabilities = wf::CAPABILITY_MANAGE_COMPOSITOR,
@@ -231,6 +274,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
     wf::effect_hook_t pre_hook = [=] ()
     {
         dim_background(background_dim);
+        update_thumbnails();
         wf::scene::damage_node(render_node, render_node->get_bounding_box());
 
         if (!duration.running())
@@ -260,6 +304,8 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
             return;
         }
 
+        destroy_thumbnail(view);
+
         bool need_action = false;
         for (auto& sv : views)
         {
@@ -337,6 +383,7 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
 
         render_node = std::make_shared<switcher_render_node_t>(this);
         wf::scene::add_front(wf::get_core().scene(), render_node);
+        wf::get_core().scene()->connect(&on_root_update);
         return true;
     }
 
@@ -349,6 +396,12 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
         wf::scene::remove_child(render_node);
         render_node = nullptr;
 
+        on_root_update.disconnect();
+        while (!thumbnails.empty())
+        {
+            destroy_thumbnail(thumbnails.begin()->first);
+        }
+
         for (auto& view : output->wset()->get_views())
         {
             if (view->has_data("switcher-minimized-showed"))
@@ -659,6 +712,13 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
                 wf::TRANSFORMER_3D, switcher_transformer);
         }
 
+        if (cache_thumbnails && !thumbnails.count(view))
+        {
+            auto& thumb = thumbnails[view];
+            thumb = std::make_unique<SwitcherThumbnail>();
+            regenerate_thumbnail_instances(view, *thumb);
+        }
+
         SwitcherView sw{duration};
         sw.view     = view;
         sw.position = SWITCHER_POSITION_CENTER;
@@ -679,6 +739,154 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
         wf::scene::run_render_pass(params, 0);
     }
 
+    void regenerate_thumbnail_instances(wayfire_toplevel_view view, SwitcherThumbnail& thumb)
+    {
+        auto transform = view->get_transformed_node()
+            ->get_transformer<wf::scene::view_3d_transformer_t>(switcher_transformer);
+
+        thumb.instances.clear();
+        if (!transform)
+        {
+            return;
+        }
+
+        auto push_damage = [thumb = &thumb] (const wf::region_t& region)
+        {
+            thumb->damage |= region;
+        };
+
+        for (auto& child : transform->get_children())
+        {
+            child->gen_render_instances(thumb.instances, push_damage, output);
+        }
+
+        thumb.damage |= transform->get_children_bounding_box();
+    }
+
+    void destroy_thumbnail(wayfire_toplevel_view view)
+    {
+        auto it = thumbnails.find(view);
+        if (it == thumbnails.end())
+        {
+            return;
+        }
+
+        OpenGL::render_begin();
+        wf::get_framebuffer_pool().release(it->second->buffer);
+        OpenGL::render_end();
+        thumbnails.erase(it);
+    }
+
+    /**
+     * Re-render the damaged thumbnails, each at most thumbnail_refresh_rate times per second.
+     * A refresh rate of 0 means that thumbnails are rendered only once.
+     */
+    void update_thumbnails()
+    {
+        const int64_t now = wf::get_current_time();
+        for (auto& [view, thumb] : thumbnails)
+        {
+            auto transform = view->get_transformed_node()
+                ->get_transformer<wf::scene::view_3d_transformer_t>(switcher_transformer);
+            if (!transform)
+            {
+                continue;
+            }
+
+            auto bbox = transform->get_children_bounding_box();
+
+            /* Use the resolution at which the view is shown in the center */
+            float view_scale = calculate_scaling_factor(bbox);
+            float scale = output->handle->scale * view_scale;
+            int width   = std::max(1.0f, std::ceil(bbox.width * scale));
+            int height  = std::max(1.0f, std::ceil(bbox.height * scale));
+
+            if ((thumb->buffer.geometry != bbox) || (thumb->buffer.scale != scale) ||
+                (thumb->buffer.viewport_width != width) || (thumb->buffer.viewport_height != height))
+            {
+                thumb->valid = false;
+            }
+
+            if (thumb->valid &&
+                (thumb->damage.empty() || (thumbnail_refresh_rate <= 0) ||
+                 (now - thumb->last_refresh < 1000 / thumbnail_refresh_rate)))
+            {
+                continue;
+            }
+
+            OpenGL::render_begin();
+            wf::get_framebuffer_pool().allocate(thumb->buffer, width, height);
+            OpenGL::render_end();
+            thumb->buffer.geometry = bbox;
+            thumb->buffer.scale    = scale;
+            if (!thumb->valid)
+            {
+                thumb->damage |= bbox;
+            }
+
+            wf::scene::render_pass_params_t params;
+            params.instances = &thumb->instances;
+            params.target    = thumb->buffer;
+            params.damage    = thumb->damage & bbox;
+            params.reference_output = output;
+            params.background_color = {0.0f, 0.0f, 0.0f, 0.0f};
+            wf::scene::run_render_pass(params, wf::scene::RPASS_CLEAR_BACKGROUND);
+
+            thumb->damage.clear();
+            thumb->view_scale   = view_scale;
+            thumb->last_refresh = now;
+            thumb->valid = true;
+        }
+    }
+
+    /**
+     * Render the view from its thumbnail, with the same transformation as the switcher transformer.
+     *
+     * @return Whether the view could be rendered from its thumbnail. This is not the case if the
+     *   view is shown bigger than the thumbnail, for example at the end of the exit animation.
+     */
+    bool render_view_thumbnail(const SwitcherView& sv,
+        wf::scene::view_3d_transformer_t *transform, const wf::render_target_t& buffer)
+    {
+        auto it = thumbnails.find(sv.view);
+        if ((it == thumbnails.end()) || !it->second->valid)
+        {
+            return false;
+        }
+
+        auto& thumb = *it->second;
+        constexpr float scale_tolerance = 1.01;
+        if (std::max((double)sv.attribs.scale_x, (double)sv.attribs.scale_y) >
+            thumb.view_scale * scale_tolerance)
+        {
+            return false;
+        }
+
+        /* Same as the rendering of view_3d_transformer_t: the quad is centered
+         * around the origin, transformed, and then moved to the view's center */
+        auto bbox = thumb.buffer.geometry;
+        auto og   = buffer.geometry;
+        gl_geometry quad = {
+            -bbox.width / 2.0f, bbox.height / 2.0f,
+            bbox.width / 2.0f, -bbox.height / 2.0f,
+        };
+
+        float off_x = (bbox.x - og.x + bbox.width / 2.0) - og.width / 2.0;
+        float off_y = og.height / 2.0 - (bbox.y - og.y + bbox.height / 2.0);
+
+        auto translate = glm::translate(glm::mat4(1.0), {off_x, off_y, 0});
+        auto scale     = glm::scale(glm::mat4(1.0), {2.0 / og.width, 2.0 / og.height, 1.0});
+        auto matrix    = buffer.gl_to_framebuffer() * scale * translate *
+            transform->calculate_total_transform();
+
+        OpenGL::render_begin(buffer);
+        buffer.logic_scissor(og);
+        OpenGL::render_transformed_texture(wf::texture_t{thumb.buffer.tex}, quad, {},
+            matrix, transform->color);
+        OpenGL::render_end();
+        return true;
+    }
+
     void render_view(const SwitcherView& sv, const wf::render_target_t& buffer)
     {
         auto transform = sv.view->get_transformed_node()
@@ -696,7 +904,10 @@ class WayfireSwitcher : public wf::per_output_plugin_instance_t, public wf::keyb
             (float)sv.attribs.rotation, {0.0, 1.0, 0.0});
 
         transform->color[3] = sv.attribs.alpha;
-        render_view_scene(sv.view, buffer);
+        if (!render_view_thumbnail(sv, transform.get(), buffer))
+        {
+            render_view_scene(sv.view, buffer);
+        }
     }
 
     void render(const wf::render_target_t& fb)
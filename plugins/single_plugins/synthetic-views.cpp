@@ -0,0 +1,534 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <wayfire/core.hpp>
+#include <wayfire/view.hpp>
+#include <wayfire/plugin.hpp>
+#include <wayfire/seat.hpp>
+#include <wayfire/output.hpp>
+#include <wayfire/opengl.hpp>
+#include <wayfire/output-layout.hpp>
+#include <wayfire/scene-render.hpp>
+#include <wayfire/scene-operations.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/workspace-set.hpp>
+#include <wayfire/util/log.hpp>
+#include "wayfire/plugins/common/shared-core-data.hpp"
+#include "plugins/ipc/ipc-helpers.hpp"
+#include "plugins/ipc/ipc-method-repository.hpp"
+
+/**
+ * The synthetic-views plugin creates large numbers of lightweight compositor-side views, so that the
+ * scenegraph, the render path and plugins reacting to views (window rules, etc.) can be tested with view
+ * counts which are impractical to reach with real clients.
+ *
+ * The views are solid rectangles which are recolored a configurable number of times per second, and are
+ * controlled with the synthetic-views/ IPC methods.
+ *
+ * The views are not toplevels: they are not part of a workspace set, cannot be focused, moved or tiled, and
+ * only exercise the parts of plugins which work with any view (for example matching window rules, but not
+ * the toplevel-only rule actions).
+ */
+namespace wf
+{
+namespace synthetic
+{
+/**
+ * The node of a synthetic view, a rectangle filled with a single color.
+ */
+class synthetic_node_t : public wf::scene::floating_inner_node_t
+{
+    class synthetic_render_instance_t : public wf::scene::simple_render_instance_t<synthetic_node_t>
+    {
+      public:
+        using simple_render_instance_t::simple_render_instance_t;
+
+        void schedule_instructions(std::vector<wf::scene::render_instruction_t>& instructions,
+            const wf::render_target_t& target, wf::region_t& damage) override
+        {
+            simple_render_instance_t::schedule_instructions(instructions, target, damage);
+            if (self->color.a >= 1.0)
+            {
+                // Nothing below an opaque view needs to be repainted.
+                damage ^= self->get_bounding_box();
+            }
+        }
+
+        void render(const wf::render_target_t& target, const wf::region_t& region) override
+        {
+            auto color = self->color;
+            wf::color_t premultiplied{color.r * color.a, color.g * color.a, color.b * color.a, color.a};
+
+            OpenGL::render_begin(target);
+            for (const auto& box : region)
+            {
+                target.logic_scissor(wlr_box_from_pixman_box(box));
+                OpenGL::render_rectangle(self->geometry, premultiplied, target.get_orthographic_projection());
+            }
+
+            OpenGL::render_end();
+        }
+    };
+
+  public:
+    wf::geometry_t geometry;
+    wf::color_t color;
+
+    synthetic_node_t(wf::geometry_t geometry, wf::color_t color) : floating_inner_node_t(false)
+    {
+        this->geometry = geometry;
+        this->color    = color;
+    }
+
+    void gen_render_instances(std::vector<wf::scene::render_instance_uptr>& instances,
+        wf::scene::damage_callback push_damage, wf::output_t *output) override
+    {
+        instances.push_back(std::make_unique<synthetic_render_instance_t>(this, push_damage, output));
+    }
+
+    wf::geometry_t get_bounding_box() override
+    {
+        return geometry;
+    }
+
+    std::string stringify() const override
+    {
+        return "synthetic-view " + stringify_flags();
+    }
+};
+
+/**
+ * A view without a client: it cannot be focused and does not receive input.
+ */
+class synthetic_view_t : public wf::view_interface_t
+{
+  public:
+    static std::shared_ptr<synthetic_view_t> create(std::string app_id, std::string title,
+        wf::geometry_t geometry, wf::color_t color)
+    {
+        auto self = view_interface_t::create<synthetic_view_t>(app_id, title);
+        self->node = std::make_shared<synthetic_node_t>(geometry, color);
+        self->set_surface_root_node(self->node);
+        self->set_role(VIEW_ROLE_DESKTOP_ENVIRONMENT);
+        return self;
+    }
+
+    /**
+     * Map the view on the given output. The view's root node should already be in the scenegraph.
+     */
+    void map(wf::output_t *output)
+    {
+        set_output(output);
+        mapped = true;
+        get_root_node()->set_enabled(true);
+        emit_view_map();
+    }
+
+    void close() override
+    {
+        if (mapped)
+        {
+            emit_view_pre_unmap();
+            mapped = false;
+            emit_view_unmap();
+        }
+    }
+
+    void set_color(wf::color_t color)
+    {
+        node->color = color;
+        damage();
+    }
+
+    wf::color_t get_color() const
+    {
+        return node->color;
+    }
+
+    void set_geometry(wf::geometry_t geometry)
+    {
+        damage();
+        node->geometry = geometry;
+        damage();
+    }
+
+    wf::geometry_t get_geometry() const
+    {
+        return node->geometry;
+    }
+
+    bool is_mapped() const override
+    {
+        return mapped;
+    }
+
+    std::string get_app_id() override
+    {
+        return app_id;
+    }
+
+    std::string get_title() override
+    {
+        return title;
+    }
+
+    wlr_surface *get_keyboard_focus_surface() override
+    {
+        return nullptr;
+    }
+
+    bool is_focusable() const override
+    {
+        return false;
+    }
+
+  private:
+    std::string app_id;
+    std::string title;
+    bool mapped = false;
+    std::shared_ptr<synthetic_node_t> node;
+
+    synthetic_view_t(std::string app_id, std::string title) : app_id(app_id), title(title)
+    {}
+
+    friend class wf::tracking_allocator_t<view_interface_t>;
+};
+
+/**
+ * A set of synthetic views created with a single spawn request.
+ *
+ * The views of a group share a single inner node, so that adding or removing thousands of views updates
+ * the scenegraph only once.
+ */
+struct group_t
+{
+    uint32_t id;
+    wf::output_t *output;
+    wf::scene::layer layer;
+    wf::dimensions_t size;
+    double opacity;
+    double update_rate;
+    uint32_t frame = 0;
+
+    std::shared_ptr<wf::scene::floating_inner_node_t> node;
+    std::vector<std::shared_ptr<synthetic_view_t>> views;
+    wf::wl_timer<true> update_timer;
+};
+}
+}
+
+static const std::map<std::string, wf::scene::layer> synthetic_layers = {
+    {"background", wf::scene::layer::BACKGROUND},
+    {"bottom", wf::scene::layer::BOTTOM},
+    {"workspace", wf::scene::layer::WORKSPACE},
+    {"top", wf::scene::layer::TOP},
+    {"overlay", wf::scene::layer::OVERLAY},
+};
+
+class wayfire_synthetic_views : public wf::plugin_interface_t
+{
+    wf::option_wrapper_t<int> default_width{"synthetic-views/width"};
+    wf::option_wrapper_t<int> default_height{"synthetic-views/height"};
+    wf::option_wrapper_t<double> default_opacity{"synthetic-views/opacity"};
+    wf::option_wrapper_t<double> default_update_rate{"synthetic-views/update_rate"};
+    wf::option_wrapper_t<int> max_views{"synthetic-views/max_views"};
+
+    wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> ipc_repo;
+
+    std::map<uint32_t, std::unique_ptr<wf::synthetic::group_t>> groups;
+    uint32_t next_group_id = 1;
+    size_t view_count = 0;
+
+  public:
+    void init() override
+    {
+        ipc_repo->register_method("synthetic-views/spawn", ipc_spawn);
+        ipc_repo->register_method("synthetic-views/configure", ipc_configure);
+        ipc_repo->register_method("synthetic-views/destroy", ipc_destroy);
+        ipc_repo->register_method("synthetic-views/list", ipc_list);
+        wf::get_core().output_layout->connect(&on_output_removed);
+    }
+
+    void fini() override
+    {
+        ipc_repo->unregister_method("synthetic-views/spawn");
+        ipc_repo->unregister_method("synthetic-views/configure");
+        ipc_repo->unregister_method("synthetic-views/destroy");
+        ipc_repo->unregister_method("synthetic-views/list");
+
+        while (!groups.empty())
+        {
+            destroy_group(groups.begin()->first);
+        }
+    }
+
+    wf::ipc::method_callback ipc_spawn = [=] (nlohmann::json data) -> nlohmann::json
+    {
+        WFJSON_EXPECT_FIELD(data, "count", number_unsigned);
+        WFJSON_OPTIONAL_FIELD(data, "output-id", number_integer);
+        WFJSON_OPTIONAL_FIELD(data, "width", number_unsigned);
+        WFJSON_OPTIONAL_FIELD(data, "height", number_unsigned);
+        WFJSON_OPTIONAL_FIELD(data, "opacity", number);
+        WFJSON_OPTIONAL_FIELD(data, "update-rate", number);
+        WFJSON_OPTIONAL_FIELD(data, "layer", string);
+        WFJSON_OPTIONAL_FIELD(data, "app-id", string);
+
+        wf::output_t *output = data.contains("output-id") ?
+            wf::ipc::find_output_by_id(data["output-id"]) : wf::get_core().seat->get_active_output();
+        if (!output)
+        {
+            return wf::ipc::json_error("output not found");
+        }
+
+        auto layer = synthetic_layers.find(data.value("layer", std::string("workspace")));
+        if (layer == synthetic_layers.end())
+        {
+            return wf::ipc::json_error("unknown layer");
+        }
+
+        size_t count = data["count"];
+        if (view_count + count > (size_t)std::max(0, (int)max_views))
+        {
+            return wf::ipc::json_error("too many views, see synthetic-views/max_views");
+        }
+
+        auto group = std::make_unique<wf::synthetic::group_t>();
+        group->id     = next_group_id++;
+        group->output = output;
+        group->layer  = layer->second;
+        group->size   = {
+            std::max(1, (int)data.value("width", (int)default_width)),
+            std::max(1, (int)data.value("height", (int)default_height)),
+        };
+        group->opacity     = std::clamp(data.value("opacity", (double)default_opacity), 0.0, 1.0);
+        group->update_rate = std::max(0.0, data.value("update-rate", (double)default_update_rate));
+        group->node = std::make_shared<wf::scene::floating_inner_node_t>(false);
+
+        std::string app_id = data.value("app-id", std::string("synthetic-view"));
+        auto output_size   = output->get_screen_size();
+        std::vector<wf::scene::node_ptr> children;
+        for (size_t i = 0; i < count; i++)
+        {
+            // Scatter the views over the output, the exact positions do not matter.
+            wf::geometry_t geometry = {
+                (int)((i * 97) % std::max(1, output_size.width - group->size.width)),
+                (int)((i * 61) % std::max(1, output_size.height - group->size.height)),
+                group->size.width,
+                group->size.height,
+            };
+
+            auto view = wf::synthetic::synthetic_view_t::create(app_id,
+                "Synthetic view " + std::to_string(group->id) + "." + std::to_string(i),
+                geometry, get_color(i, group->opacity));
+            children.push_back(view->get_root_node());
+            group->views.push_back(view);
+        }
+
+        group->node->set_children_list(children);
+        auto parent = (group->layer == wf::scene::layer::WORKSPACE) ?
+            output->wset()->get_node() : output->node_for_layer(group->layer);
+        wf::scene::add_front(parent, group->node);
+
+        for (auto& view : group->views)
+        {
+            view->map(output);
+        }
+
+        view_count += count;
+        auto response = wf::ipc::json_ok();
+        response["group"] = group->id;
+        response["views"] = nlohmann::json::array();
+        for (auto& view : group->views)
+        {
+            response["views"].push_back(view->get_id());
+        }
+
+        auto& inserted = groups[group->id];
+        inserted = std::move(group);
+        schedule_updates(*inserted);
+        LOGI("Spawned ", count, " synthetic views on ", output->to_string());
+        return response;
+    };
+
+    wf::ipc::method_callback ipc_configure = [=] (nlohmann::json data) -> nlohmann::json
+    {
+        WFJSON_EXPECT_FIELD(data, "group", number_unsigned);
+        WFJSON_OPTIONAL_FIELD(data, "width", number_unsigned);
+        WFJSON_OPTIONAL_FIELD(data, "height", number_unsigned);
+        WFJSON_OPTIONAL_FIELD(data, "opacity", number);
+        WFJSON_OPTIONAL_FIELD(data, "update-rate", number);
+
+        auto it = groups.find(data["group"]);
+        if (it == groups.end())
+        {
+            return wf::ipc::json_error("group not found");
+        }
+
+        auto& group = *it->second;
+        if (data.contains("width") || data.contains("height"))
+        {
+            group.size = {
+                std::max(1, (int)data.value("width", group.size.width)),
+                std::max(1, (int)data.value("height", group.size.height)),
+            };
+
+            for (auto& view : group.views)
+            {
+                auto geometry = view->get_geometry();
+                view->set_geometry({geometry.x, geometry.y, group.size.width, group.size.height});
+            }
+        }
+
+        if (data.contains("opacity"))
+        {
+            group.opacity = std::clamp((double)data["opacity"], 0.0, 1.0);
+            recolor(group);
+        }
+
+        if (data.contains("update-rate"))
+        {
+            group.update_rate = std::max(0.0, (double)data["update-rate"]);
+            schedule_updates(group);
+        }
+
+        return wf::ipc::json_ok();
+    };
+
+    wf::ipc::method_callback ipc_destroy = [=] (nlohmann::json data) -> nlohmann::json
+    {
+        WFJSON_OPTIONAL_FIELD(data, "group", number_unsigned);
+        if (!data.contains("group"))
+        {
+            while (!groups.empty())
+            {
+                destroy_group(groups.begin()->first);
+            }
+
+            return wf::ipc::json_ok();
+        }
+
+        if (!groups.count(data["group"]))
+        {
+            return wf::ipc::json_error("group not found");
+        }
+
+        destroy_group(data["group"]);
+        return wf::ipc::json_ok();
+    };
+
+    wf::ipc::method_callback ipc_list = [=] (nlohmann::json) -> nlohmann::json
+    {
+        auto response = wf::ipc::json_ok();
+        response["groups"] = nlohmann::json::array();
+        for (auto& [id, group] : groups)
+        {
+            nlohmann::json description;
+            description["group"]  = id;
+            description["output"] = group->output->get_id();
+            description["count"]  = group->views.size();
+            description["size"]   = wf::ipc::dimensions_to_json(group->size);
+            description["opacity"]     = group->opacity;
+            description["update-rate"] = group->update_rate;
+            response["groups"].push_back(description);
+        }
+
+        response["count"] = view_count;
+        return response;
+    };
+
+  private:
+    wf::signal::connection_t<wf::output_pre_remove_signal> on_output_removed =
+        [=] (wf::output_pre_remove_signal *ev)
+    {
+        std::vector<uint32_t> to_destroy;
+        for (auto& [id, group] : groups)
+        {
+            if (group->output == ev->output)
+            {
+                to_destroy.push_back(id);
+            }
+        }
+
+        for (auto id : to_destroy)
+        {
+            destroy_group(id);
+        }
+    };
+
+    /**
+     * Pick a color for the given view and frame: the views of a group cycle through the hues, so that
+     * neighbouring views have different colors and every update changes the whole view.
+     */
+    static wf::color_t get_color(size_t index, double opacity, uint32_t frame = 0)
+    {
+        double hue = std::fmod((index * 37 + frame * 8) / 360.0, 1.0) * 6.0;
+        double x   = 1.0 - std::abs(std::fmod(hue, 2.0) - 1.0);
+        switch ((int)hue)
+        {
+          case 0:
+            return {1, x, 0, opacity};
+
+          case 1:
+            return {x, 1, 0, opacity};
+
+          case 2:
+            return {0, 1, x, opacity};
+
+          case 3:
+            return {0, x, 1, opacity};
+
+          case 4:
+            return {x, 0, 1, opacity};
+
+          default:
+            return {1, 0, x, opacity};
+        }
+    }
+
+    void recolor(wf::synthetic::group_t& group)
+    {
+        for (size_t i = 0; i < group.views.size(); i++)
+        {
+            group.views[i]->set_color(get_color(i, group.opacity, group.frame));
+        }
+    }
+
+    void schedule_updates(wf::synthetic::group_t& group)
+    {
+        group.update_timer.disconnect();
+        if (group.update_rate <= 0)
+        {
+            return;
+        }
+
+        uint32_t interval = std::max(1.0, std::round(1000.0 / group.update_rate));
+        group.update_timer.set_timeout(interval, [this, &group] ()
+        {
+            group.frame++;
+            recolor(group);
+            return true;
+        });
+    }
+
+    void destroy_group(uint32_t id)
+    {
+        auto group = std::move(groups[id]);
+        groups.erase(id);
+        group->update_timer.disconnect();
+
+        // Detach all views at once before unmapping them. The scenegraph update of each unmapped view then
+        // stops at its detached root node, instead of refocusing the whole scenegraph once per view.
+        wf::scene::remove_child(group->node);
+        group->node->set_children_list({});
+        for (auto& view : group->views)
+        {
+            view->close();
+        }
+
+        wf::scene::update(wf::get_core().scene(), wf::scene::update_flag::REFOCUS);
+        view_count -= group->views.size();
+    }
+};
+
+DECLARE_WAYFIRE_PLUGIN(wayfire_synthetic_views);
@@ -167,6 +167,12 @@ class wf_wrot : public wf::per_output_plugin_instance_t, public wf::pointer_inte
     };
 
   public:
+    static constexpr bool can_defer_init()
+    {
+        // Only reacts to bindings.
+        return true;
+    }
+
     void init() override
     {
         input_grab = std::make_unique<wf::input_grab_t>("wrot", output, nullptr, this, nullptr);
@@ -25,6 +25,12 @@ class wayfire_zoom_screen : public wf::per_output_plugin_instance_t
     };
 
   public:
+    static constexpr bool can_defer_init()
+    {
+        // Only reacts to bindings.
+        return true;
+    }
+
     void init() override
     {
         progression.set(1, 1);
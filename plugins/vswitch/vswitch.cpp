@@ -7,6 +7,7 @@
 #include <wayfire/seat.hpp>
 #include "plugins/ipc/ipc-method-repository.hpp"
 #include "wayfire/plugins/common/shared-core-data.hpp"
+#include "wayfire/plugins/common/workspace-thumbnail-cache.hpp"
 
 class vswitch : public wf::per_output_plugin_instance_t
 {
@@ -234,18 +235,36 @@ class vswitch : public wf::per_output_plugin_instance_t
 class wf_vswitch_global_plugin_t : public wf::per_output_plugin_t<vswitch>
 {
     wf::shared_data::ref_ptr_t<wf::ipc::method_repository_t> ipc_repo;
+    wf::option_wrapper_t<bool> cache_thumbnails{"vswitch/cache_thumbnails"};
+
+    /* Keeps the workspace thumbnail cache alive while enabled */
+    std::optional<wf::shared_data::ref_ptr_t<wf::workspace_thumbnail_cache_t>> thumbnail_cache;
+
+    void update_thumbnail_cache()
+    {
+        if (cache_thumbnails && !thumbnail_cache)
+        {
+            thumbnail_cache.emplace();
+        } else if (!cache_thumbnails)
+        {
+            thumbnail_cache.reset();
+        }
+    }
 
   public:
     void init() override
     {
         per_output_plugin_t::init();
         ipc_repo->register_method("vswitch/set-workspace", request_workspace);
+        cache_thumbnails.set_callback([=] () { update_thumbnail_cache(); });
+        update_thumbnail_cache();
     }
 
     void fini() override
     {
         per_output_plugin_t::fini();
         ipc_repo->unregister_method("vswitch/set-workspace");
+        thumbnail_cache.reset();
     }
 
     wf::ipc::method_callback request_workspace = [=] (const nlohmann::json& data)
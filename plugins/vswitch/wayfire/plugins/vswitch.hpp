@@ -112,6 +112,7 @@ class workspace_switch_t
         wall->set_viewport(wall->get_workspace_rectangle(
             output->wset()->get_current_workspace()));
         wall->set_background_color(background_color);
+        wall->set_update_budget(update_budget);
         wall->start_output_renderer();
 
         if (overlay_view_node)
@@ -240,6 +241,7 @@ class workspace_switch_t
   protected:
     option_wrapper_t<int> gap{"vswitch/gap"};
     option_wrapper_t<color_t> background_color{"vswitch/background"};
+    option_wrapper_t<int> update_budget{"vswitch/update_budget"};
     workspace_animation_t animation;
 
     output_t *output;
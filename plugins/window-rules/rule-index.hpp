@@ -0,0 +1,198 @@
+#ifndef RULE_INDEX_HPP
+#define RULE_INDEX_HPP
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "wayfire/action/action_interface.hpp"
+#include "wayfire/condition/access_interface.hpp"
+#include "wayfire/variant.hpp"
+
+namespace wf
+{
+/**
+ * @brief get_rule_signal Find the signal a rule reacts to.
+ *
+ * Rules (and lambda rules) start with "on <signal>", for example
+ * "on created if app_id is \"foot\" then maximize".
+ *
+ * @param[in] rule_text The text of the rule.
+ *
+ * @return The signal name, or an empty string if it cannot be determined.
+ */
+inline std::string get_rule_signal(const std::string & rule_text)
+{
+    std::istringstream stream(rule_text);
+    std::string on, signal;
+    if ((stream >> on >> signal) && (on == "on"))
+    {
+        return signal;
+    }
+
+    return "";
+}
+
+/**
+ * @brief The signal_rule_index_t class groups rules by the signal they react to, so
+ * that applying the rules for a signal does not have to look at all the other rules.
+ *
+ * Rules whose signal is unknown are returned for every signal. For each signal, the
+ * rules are kept in the order they were added in.
+ */
+template<class Rule>
+class signal_rule_index_t
+{
+  public:
+    /**
+     * @brief add Add a rule to the index.
+     *
+     * @param[in] signal The signal the rule reacts to, or an empty string if unknown.
+     * @param[in] rule The rule.
+     */
+    void add(const std::string & signal, Rule rule)
+    {
+        if (signal.empty())
+        {
+            for (auto& [_, rules] : _by_signal)
+            {
+                rules.push_back(rule);
+            }
+
+            _unindexed.push_back(rule);
+            return;
+        }
+
+        auto it = _by_signal.find(signal);
+        if (it == _by_signal.end())
+        {
+            // Rules with an unknown signal which were added so far come first.
+            it = _by_signal.emplace(signal, _unindexed).first;
+        }
+
+        it->second.push_back(rule);
+    }
+
+    /**
+     * @brief get Get the rules which may react to the given signal, in order.
+     */
+    const std::vector<Rule>& get(const std::string & signal) const
+    {
+        auto it = _by_signal.find(signal);
+        return (it == _by_signal.end()) ? _unindexed : it->second;
+    }
+
+    void clear()
+    {
+        _by_signal.clear();
+        _unindexed.clear();
+    }
+
+  private:
+    std::unordered_map<std::string, std::vector<Rule>> _by_signal;
+    std::vector<Rule> _unindexed;
+};
+
+/**
+ * @brief The cached_access_interface_t class remembers the properties it has looked
+ * up from another access interface.
+ *
+ * When many rules are evaluated for the same view, each property of the view (which
+ * may involve string formatting and casts) is then computed only once.
+ *
+ * Some properties (like the title and the app-id) can be cached for longer, as long as
+ * the caller knows that they have not changed. They are stored in a separate property
+ * cache, see set_persistent_cache().
+ *
+ * @note The cache has to be cleared whenever the view or its state may have changed,
+ * for example after a rule has executed an action. Wrap the action interface in an
+ * invalidating_action_interface_t for that.
+ */
+class cached_access_interface_t : public access_interface_t
+{
+  public:
+    using property_cache_t = std::unordered_map<std::string, std::pair<variant_t, bool>>;
+
+    /**
+     * @param[in] source The access interface to look the properties up from.
+     * @param[in] persistent The properties which are stored in the persistent cache.
+     */
+    cached_access_interface_t(access_interface_t & source,
+        std::unordered_set<std::string> persistent = {}) :
+        _source(source), _persistent(std::move(persistent))
+    {}
+
+    // Inherits docs.
+    virtual variant_t get(const std::string & identifier, bool & error) override
+    {
+        auto& cache = (_persistent_cache && _persistent.count(identifier)) ?
+            *_persistent_cache : _cache;
+        auto it = cache.find(identifier);
+        if (it == cache.end())
+        {
+            bool source_error = false;
+            auto value = _source.get(identifier, source_error);
+            it = cache.emplace(identifier, std::make_pair(value, source_error)).first;
+        }
+
+        error = it->second.second;
+        return it->second.first;
+    }
+
+    /**
+     * @brief set_persistent_cache Set the cache for the persistent properties. It is
+     * owned by the caller and is not affected by clear().
+     *
+     * @param[in] cache The cache, or nullptr to cache all properties until clear().
+     */
+    void set_persistent_cache(property_cache_t *cache)
+    {
+        _persistent_cache = cache;
+    }
+
+    /**
+     * @brief clear Forget all cached properties, except for the persistent ones.
+     */
+    void clear()
+    {
+        _cache.clear();
+    }
+
+  private:
+    access_interface_t & _source;
+    std::unordered_set<std::string> _persistent;
+    property_cache_t *_persistent_cache = nullptr;
+    property_cache_t _cache;
+};
+
+/**
+ * @brief The invalidating_action_interface_t class forwards actions to another action
+ * interface and clears a property cache each time, since the action may change the
+ * properties of the view.
+ */
+class invalidating_action_interface_t : public action_interface_t
+{
+  public:
+    invalidating_action_interface_t(action_interface_t & target,
+        cached_access_interface_t & cache) : _target(target), _cache(cache)
+    {}
+
+    // Inherits docs.
+    virtual bool execute(const std::string & name,
+        const std::vector<variant_t> & args) override
+    {
+        bool error = _target.execute(name, args);
+        _cache.clear();
+        return error;
+    }
+
+  private:
+    action_interface_t & _target;
+    cached_access_interface_t & _cache;
+};
+} // End namespace wf.
+
+#endif // RULE_INDEX_HPP
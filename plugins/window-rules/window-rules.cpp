@@ -1,4 +1,5 @@
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <wayfire/per-output-plugin.hpp>
@@ -14,8 +15,10 @@
 #include <wayfire/util/log.hpp>
 #include <wayfire/option-wrapper.hpp>
 #include <wayfire/toplevel-view.hpp>
+#include <wayfire/nonstd/tracking-allocator.hpp>
 
 #include "lambda-rules-registration.hpp"
+#include "rule-index.hpp"
 #include "view-action-interface.hpp"
 #include "wayfire/signal-provider.hpp"
 
@@ -58,14 +61,41 @@ class wayfire_window_rules_t : public wf::per_output_plugin_instance_t
     // Auto-reload on changes to config file
     wf::signal::connection_t<wf::reload_config_signal> _reload_config = [=] (wf::reload_config_signal *ev)
     {
-        setup_rules_from_config();
+        if (ev->may_have_changed("window-rules"))
+        {
+            setup_rules_from_config();
+        }
     };
 
-    std::vector<std::shared_ptr<wf::rule_t>> _rules;
+    wf::signal_rule_index_t<std::shared_ptr<wf::rule_t>> _rules;
 
     wf::view_access_interface_t _access_interface;
     wf::view_action_interface_t _action_interface;
 
+    // Rules for the same view look up the same properties over and over again.
+    // Properties covered by view_interface_t::get_properties_version() are kept per view.
+    wf::cached_access_interface_t _cached_access_interface{_access_interface,
+        {"app_id", "title", "activated", "minimized", "mapped"}};
+    wf::invalidating_action_interface_t _invalidating_action_interface{_action_interface,
+        _cached_access_interface};
+
+    struct view_properties_t
+    {
+        uint64_t version;
+        wf::cached_access_interface_t::property_cache_t properties;
+    };
+
+    std::unordered_map<uint32_t, view_properties_t> _view_properties;
+
+    wf::cached_access_interface_t::property_cache_t& get_view_properties(wayfire_view view);
+
+    // Connected to each view in _view_properties, to drop its entry when it is destroyed.
+    wf::signal::connection_t<wf::destruct_signal<wf::view_interface_t>> _on_view_destruct =
+        [=] (wf::destruct_signal<wf::view_interface_t> *ev)
+    {
+        _view_properties.erase(ev->object->get_id());
+    };
+
     nonstd::observer_ptr<wf::lambda_rules_registrations_t> _lambda_registrations;
 };
 
@@ -86,6 +116,9 @@ void wayfire_window_rules_t::init()
 
 void wayfire_window_rules_t::fini()
 {
+    _on_view_destruct.disconnect();
+    _view_properties.clear();
+
     _lambda_registrations->window_rule_instances--;
     if (_lambda_registrations->window_rule_instances == 0)
     {
@@ -111,17 +144,23 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
         return;
     }
 
-    for (const auto & rule : _rules)
+    _access_interface.set_view(view);
+    _action_interface.set_view(view);
+    _cached_access_interface.clear();
+    _cached_access_interface.set_persistent_cache(&get_view_properties(view));
+    for (const auto & rule : _rules.get(signal))
     {
-        _access_interface.set_view(view);
-        _action_interface.set_view(view);
-        auto error = rule->apply(signal, _access_interface, _action_interface);
+        auto error = rule->apply(signal, _cached_access_interface, _invalidating_action_interface);
         if (error)
         {
             LOGE("Window-rules: Error while executing rule on ", signal, " signal.");
         }
     }
 
+    // Lambda rules run arbitrary code, which may change the view in ways we do not see.
+    _cached_access_interface.clear();
+    _cached_access_interface.set_persistent_cache(nullptr);
+
     auto bounds = _lambda_registrations->rules();
     auto begin  = std::get<0>(bounds);
     auto end    = std::get<1>(bounds);
@@ -129,6 +168,11 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
     {
         auto registration = std::get<1>(*begin);
         bool error = false;
+        if (!registration->signal.empty() && (registration->signal != signal))
+        {
+            ++begin;
+            continue;
+        }
 
         // Assume we will use the view access interface.
         _access_interface.set_view(view);
@@ -177,6 +221,24 @@ void wayfire_window_rules_t::apply(const std::string & signal, wayfire_view view
     }
 }
 
+wf::cached_access_interface_t::property_cache_t& wayfire_window_rules_t::get_view_properties(
+    wayfire_view view)
+{
+    auto version = view->get_properties_version();
+    auto it = _view_properties.find(view->get_id());
+    if (it == _view_properties.end())
+    {
+        view->connect(&_on_view_destruct);
+        it = _view_properties.emplace(view->get_id(), view_properties_t{version, {}}).first;
+    } else if (it->second.version != version)
+    {
+        it->second.version = version;
+        it->second.properties.clear();
+    }
+
+    return it->second.properties;
+}
+
 void wayfire_window_rules_t::setup_rules_from_config()
 {
     _rules.clear();
@@ -191,7 +253,7 @@ void wayfire_window_rules_t::setup_rules_from_config()
         auto rule = wf::rule_parser_t().parse(_lexer);
         if (rule != nullptr)
         {
-            _rules.push_back(rule);
+            _rules.add(wf::get_rule_signal(rule_str), rule);
         }
     }
 }
@@ -1,6 +1,7 @@
 #include "wayfire/debug.hpp"
 #include "wayfire/opengl.hpp"
 #include "wayfire/region.hpp"
+#include <chrono>
 #include <memory>
 #include <wayfire/plugin.hpp>
 #include <wayfire/signal-definitions.hpp>
@@ -549,7 +550,7 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
         this->view = view;
         this->wobbly_program = wobbly_prog;
         init_model();
-        last_frame = wf::get_current_time();
+        last_frame = std::chrono::steady_clock::now();
         view->get_output()->connect(&on_workspace_changed);
 
         view->connect(&on_view_unmap);
@@ -651,7 +652,8 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
     };
 
     std::unique_ptr<wf::iwobbly_state_t> state;
-    uint32_t last_frame;
+    // The presentation time of the last frame the model was advanced to
+    std::chrono::steady_clock::time_point last_frame;
     bool force_tile = false;
 
     void init_model()
@@ -676,9 +678,17 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
     }
 
   public:
-    void update_model()
+    void update_model(wf::animation_frame_t& frame)
     {
-        view->damage();
+        if (frame.suspended)
+        {
+            // Nothing is shown, keep the model where it is instead of simulating all the missed frames
+            // once the output is shown again.
+            last_frame = frame.presentation_time;
+            return;
+        }
+
+        frame.damage_node(view->get_transformed_node());
 
         /* It is possible that the wobbly state needs to adjust view geometry.
          * We do not want it to get feedback from itself */
@@ -686,15 +696,15 @@ class wobbly_transformer_node_t : public wf::scene::transformer_base_node_t
         state->handle_frame();
         view->connect(&on_view_geometry_changed);
 
-        /* Update all the wobbly model */
-        auto now = wf::get_current_time();
-
-        if (now > last_frame)
+        /* Advance the model to the time the frame will be shown */
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            frame.presentation_time - last_frame).count();
+        if (elapsed > 0)
         {
             view->get_transformed_node()->begin_transform_update();
-            wobbly_prepare_paint(model.get(), now - last_frame);
+            wobbly_prepare_paint(model.get(), elapsed);
             /* Update wobbly geometry */
-            last_frame = now;
+            last_frame += std::chrono::milliseconds(elapsed);
             wobbly_add_geometry(model.get());
             wobbly_done_paint(model.get());
             view->get_transformed_node()->end_transform_update();
@@ -856,7 +866,7 @@ class wobbly_render_instance_t :
     public wf::scene::transformer_render_instance_t<wobbly_transformer_node_t>
 {
     wf::output_t *wo = nullptr;
-    wf::effect_hook_t pre_hook;
+    wf::animation_hook_t animation_hook;
 
   public:
     wobbly_render_instance_t(wobbly_transformer_node_t *self, wf::scene::damage_callback push_damage,
@@ -865,8 +875,8 @@ class wobbly_render_instance_t :
         if (shown_on)
         {
             wo = shown_on;
-            pre_hook = [=] () { self->update_model(); };
-            wo->render->add_effect(&pre_hook, wf::OUTPUT_EFFECT_PRE);
+            animation_hook = [=] (wf::animation_frame_t& frame) { self->update_model(frame); };
+            wo->render->add_animation(&animation_hook);
         }
     }
 
@@ -874,7 +884,7 @@ class wobbly_render_instance_t :
     {
         if (wo)
         {
-            wo->render->rem_effect(&pre_hook);
+            wo->render->rem_animation(&animation_hook);
         }
     }
 
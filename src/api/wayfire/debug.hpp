@@ -65,6 +65,12 @@ enum class logging_category : size_t
     IM      = 10,
     // Rendering-related events
     RENDER  = 11,
+    // Plugin loading and initialization
+    PLUGINS = 12,
+    // Trace events, see wayfire/trace.hpp
+    TRACE   = 13,
+    // GPU resource allocation, see wayfire/gpu-resources.hpp
+    GPU     = 14,
     TOTAL,
 };
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <wayfire/opengl.hpp>
+#include <cstddef>
+#include <memory>
+
+namespace wf
+{
+/**
+ * A pool of offscreen framebuffers, shared by all users of short-lived auxiliary buffers, for example
+ * transformers and workspace walls.
+ *
+ * Framebuffers which are released to the pool are kept for a while, and reused by the next allocation with
+ * the same size instead of creating a new texture and framebuffer. This avoids a lot of work in the driver
+ * when many buffers are created and destroyed at once, for example when scale or expo start and stop.
+ *
+ * Idle framebuffers are destroyed when they have not been used for a few seconds, and the least recently
+ * used ones are destroyed as soon as the idle framebuffers exceed the memory budget set by the option
+ * core/framebuffer_pool_size.
+ *
+ * Like framebuffer_t::allocate(), all functions need to be called between OpenGL::render_begin() and
+ * OpenGL::render_end().
+ */
+class framebuffer_pool_t
+{
+  public:
+    framebuffer_pool_t();
+    ~framebuffer_pool_t();
+
+    framebuffer_pool_t(const framebuffer_pool_t&) = delete;
+    framebuffer_pool_t(framebuffer_pool_t&&) = delete;
+    framebuffer_pool_t& operator =(const framebuffer_pool_t&) = delete;
+    framebuffer_pool_t& operator =(framebuffer_pool_t&&) = delete;
+
+    /**
+     * Make sure @fb has the given size. If it already has a buffer with a different size, it is released
+     * to the pool first, and a buffer of the correct size is taken from the pool or created.
+     *
+     * @return true if the framebuffer contents are undefined, like framebuffer_t::allocate().
+     */
+    bool allocate(wf::framebuffer_t& fb, int width, int height);
+
+    /**
+     * Return the buffer of @fb to the pool and reset @fb. No-op if @fb has no buffer.
+     * The framebuffer must have been allocated with allocate().
+     */
+    void release(wf::framebuffer_t& fb);
+
+    /**
+     * Destroy all idle framebuffers.
+     */
+    void clear();
+
+    struct stats_t
+    {
+        /** The number and size in bytes of the framebuffers currently in use. */
+        size_t used_buffers = 0;
+        size_t used_bytes   = 0;
+        /** The number and size in bytes of the idle framebuffers kept for reuse. */
+        size_t idle_buffers = 0;
+        size_t idle_bytes   = 0;
+        /** How many allocations were served from the pool and how many created a new buffer. */
+        size_t reused  = 0;
+        size_t created = 0;
+    };
+
+    stats_t get_stats() const;
+
+  private:
+    class impl;
+    std::unique_ptr<impl> priv;
+};
+
+/**
+ * Get the framebuffer pool shared by Wayfire and all plugins.
+ */
+framebuffer_pool_t& get_framebuffer_pool();
+}
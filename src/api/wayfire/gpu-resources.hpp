@@ -0,0 +1,70 @@
+#pragma once
+
+#include <GLES3/gl3.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * A registry of the GL textures and framebuffers allocated by Wayfire and its plugins, for finding out who
+ * holds how much GPU memory. Client buffers imported by wlroots are not included.
+ *
+ * Each resource is attributed to the module (Wayfire itself or a plugin) which allocated it. It is found
+ * from the address of the code which allocated the resource, so for example framebuffers allocated by a
+ * helper in plugins/common are attributed to the plugin using the helper.
+ *
+ * The registry can be queried with the wayfire/gpu-resources IPC method. With `-d gpu`, allocations and
+ * deallocations are also logged.
+ */
+namespace wf
+{
+namespace gpu_resources
+{
+enum class resource_type_t
+{
+    TEXTURE,
+    FRAMEBUFFER,
+};
+
+struct resource_t
+{
+    resource_type_t type;
+    GLuint id;
+    int width  = 0;
+    int height = 0;
+    /** An estimate of the memory used by the resource. Framebuffers do not count their attachments. */
+    size_t bytes = 0;
+    /** The name of the module which allocated the resource, e.g. "wayfire" or "blur". */
+    std::string owner;
+};
+
+/**
+ * Record a new texture, or update the size of a texture which is already tracked.
+ *
+ * @param caller An address in the code which allocated the resource, usually
+ *   __builtin_return_address(0) or the address of the allocating function.
+ */
+void track_texture(GLuint tex, int width, int height, const void *caller);
+
+/**
+ * Record a new framebuffer object.
+ */
+void track_framebuffer(GLuint fb, const void *caller);
+
+/**
+ * Attribute a tracked resource to another module, for example when a pooled buffer is handed out.
+ */
+void set_owner(resource_type_t type, GLuint id, const void *caller);
+
+/**
+ * Remove a resource from the registry. No-op if the resource is not tracked.
+ */
+void untrack_texture(GLuint tex);
+void untrack_framebuffer(GLuint fb);
+
+/**
+ * Get a list of all tracked resources.
+ */
+std::vector<resource_t> get_resources();
+}
+}
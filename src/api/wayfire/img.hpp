@@ -2,23 +2,91 @@
 #define IMG_HPP_
 
 #include <wayfire/opengl.hpp>
+#include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace image_io
 {
+/**
+ * An image decoded to memory.
+ */
+struct decoded_image_t
+{
+    int width  = 0;
+    int height = 0;
+    /** 4 for RGBA, 3 for RGB pixel data. */
+    int channels = 4;
+    /** The pixels, row by row, starting from the top row. Rows are tightly packed. */
+    std::vector<uint8_t> pixels;
+};
+
+/* Decode the image from the given file to memory.
+ * Supported types are png and jpg (when built with image support) and qoi.
+ * Decoded images are cached by path, modification time and file size, so decoding
+ * an unchanged file a second time is cheap.
+ * May be called from any thread. Returns nullptr if the image could not be decoded. */
+std::shared_ptr<const decoded_image_t> decode_file(std::string name);
+
+/** A pending asynchronous decode request, see decode_file_async(). */
+struct decode_request_t;
+using decode_callback_t = std::function<void (std::shared_ptr<const decoded_image_t>)>;
+
+/* Decode the image from the given file on a background thread.
+ * The callback is called on the main thread with the decoded image, or with nullptr on failure.
+ * If the result is already known (cache hit, file missing), the callback is called immediately
+ * and nullptr is returned.
+ * Otherwise, the callback is called only if the returned request is still alive when decoding
+ * finishes, so dropping it cancels the callback. */
+std::shared_ptr<decode_request_t> decode_file_async(std::string name, decode_callback_t callback);
+
+/* Upload a decoded image to the texture bound to the given target,
+ * GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP.
+ * The texture is recorded in the GPU resource registry for the caller, so it should be removed with
+ * wf::gpu_resources::untrack_texture() when it is deleted.
+ * Guaranteed: doesn't change any GL state except pixel packing */
+bool upload_to_texture(const decoded_image_t& image, GLuint target);
+
 /* Load the image from the given file, binding it to the given GL texture target
  * Bind the texture before you call this function
+ * Like upload_to_texture(), this records the texture in the GPU resource registry.
  * Guaranteed: doesn't change any GL state except pixel packing */
 bool load_from_file(std::string name, GLuint target);
 
-/* Function that saves the given pixels(in rgba format) to a (currently) png file */
+/* An encoder which saves the given pixels (in rgba format) to a file.
+ * Encoders may run on worker threads, so they must not touch compositor state. */
+using writer_t = std::function<bool (const char *name, uint8_t *pixels, unsigned long w,
+    unsigned long h, bool invert)>;
+
+/* Register an encoder for the given image type, replacing any existing encoder for it.
+ * Built-in types are "png" (when built with image support) and "qoi", which is much faster
+ * to encode than png, at the cost of larger files. May be called from any thread. */
+void register_writer(std::string type, writer_t writer);
+
+/* Function that saves the given pixels(in rgba format) to a file of the given type */
 void write_to_file(std::string name, uint8_t *pixels, int w, int h,
     std::string type, bool invert = false);
 
 void write_to_file(std::string name, wf::framebuffer_t buffer);
 
+/** A pending asynchronous write, see write_to_file_async(). */
+struct write_request_t;
+
+/* Save the contents of the framebuffer to a file without stalling the compositor.
+ * The pixels are copied to a pixel buffer object, and once the GPU has finished the copy,
+ * they are encoded on a worker thread.
+ * The framebuffer may be reused or destroyed as soon as this function returns.
+ * The callback is called on the main thread with the result, but only if the returned request
+ * is still alive at that point. The file is written either way. */
+std::shared_ptr<write_request_t> write_to_file_async(std::string name, wf::framebuffer_t buffer,
+    std::string type = "png", std::function<void (bool)> callback = {});
+
 /* Initializes all backends, called at startup */
 void init();
+
+/* Drops pending asynchronous writes, called at shutdown */
+void fini();
 }
 
 #endif /* end of include guard: IMG_HPP_ */
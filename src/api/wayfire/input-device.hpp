@@ -2,9 +2,44 @@
 #define WF_INPUT_DEVICE_HPP
 
 #include <wayfire/nonstd/wlroots.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 
 namespace wf
 {
+/**
+ * A histogram of input latencies, i.e. the time from an input event reaching the compositor until the
+ * first frame after it was presented on an output.
+ */
+struct input_latency_histogram_t
+{
+    /**
+     * The upper bounds of the buckets, in microseconds. Latencies above the last bound go into an additional
+     * bucket at the end.
+     */
+    static constexpr std::array<int64_t, 8> bucket_bounds_us = {
+        1000, 2000, 4000, 8000, 16000, 32000, 64000, 128000
+    };
+
+    std::array<uint64_t, bucket_bounds_us.size() + 1> buckets = {};
+    uint64_t count = 0;
+    int64_t min_us = 0;
+    int64_t max_us = 0;
+    int64_t total_us = 0;
+
+    void add(int64_t latency_us)
+    {
+        auto it = std::lower_bound(bucket_bounds_us.begin(), bucket_bounds_us.end(), latency_us);
+        buckets[it - bucket_bounds_us.begin()]++;
+
+        min_us    = (count == 0) ? latency_us : std::min(min_us, latency_us);
+        max_us    = std::max(max_us, latency_us);
+        total_us += latency_us;
+        count++;
+    }
+};
+
 class input_device_t
 {
   public:
@@ -25,11 +60,20 @@ class input_device_t
      * @return true if the compositor should receive events from the device
      */
     bool is_enabled();
+
+    /**
+     * @return The input latency measured for events from this device.
+     */
+    input_latency_histogram_t& get_latency_histogram();
+
     virtual ~input_device_t() = default;
 
   protected:
     wlr_input_device *handle;
     input_device_t(wlr_input_device *handle);
+
+  private:
+    input_latency_histogram_t latency_histogram;
 };
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 #include <memory>
 #include <functional>
+#include <unordered_map>
 #include <wayfire/dassert.hpp>
+#include <wayfire/object.hpp>
 #include <wayfire/nonstd/observer_ptr.h>
 #include <wayfire/signal-provider.hpp>
 
@@ -21,6 +23,8 @@ struct destruct_signal
  * The tracking allocator is a factory singleton for allocating objects of a certain type.
  * The objects are allocated via shared pointers, and the tracking allocator keeps a list of all allocated
  * objects, accessible by plugins.
+ *
+ * Objects derived from wf::object_base_t are additionally indexed by their id, see find_by_id().
  */
 template<class ObjectType>
 class tracking_allocator_t
@@ -44,6 +48,11 @@ class tracking_allocator_t
             std::bind(&tracking_allocator_t<ObjectType>::deallocate_object, this, std::placeholders::_1));
 
         allocated_objects.push_back(ptr.get());
+        if constexpr (has_id)
+        {
+            objects_by_id[static_cast<ObjectType*>(ptr.get())->get_id()] = ptr.get();
+        }
+
         return ptr;
     }
 
@@ -52,8 +61,28 @@ class tracking_allocator_t
         return allocated_objects;
     }
 
+    /**
+     * Find an allocated object by its id (see object_base_t::get_id()) in constant time.
+     *
+     * @return The object, or nullptr if there is no such object.
+     */
+    nonstd::observer_ptr<ObjectType> find_by_id(uint32_t id) const
+    {
+        static_assert(has_id, "Only objects derived from wf::object_base_t have an id!");
+        auto it = objects_by_id.find(id);
+        if (it == objects_by_id.end())
+        {
+            return nullptr;
+        }
+
+        return it->second;
+    }
+
   private:
+    static constexpr bool has_id = std::is_base_of_v<wf::object_base_t, ObjectType>;
+
     std::vector<nonstd::observer_ptr<ObjectType>> allocated_objects;
+    std::unordered_map<uint32_t, nonstd::observer_ptr<ObjectType>> objects_by_id;
     void deallocate_object(ObjectType *obj)
     {
         if constexpr (std::is_base_of_v<wf::signal::provider_t, ObjectType>)
@@ -67,6 +96,11 @@ class tracking_allocator_t
             nonstd::observer_ptr<ObjectType>{obj});
         wf::dassert(it != allocated_objects.end(), "Object is not allocated?");
         allocated_objects.erase(it);
+        if constexpr (has_id)
+        {
+            objects_by_id.erase(obj->get_id());
+        }
+
         delete obj;
     }
 };
@@ -21,6 +21,15 @@ class per_output_plugin_instance_t
     virtual void fini()
     {}
     virtual ~per_output_plugin_instance_t() = default;
+
+    /**
+     * The result of plugin_interface_t::can_defer_init() for per_output_plugin_t. It is queried before
+     * any instance exists, so subclasses hide it with their own static function instead of overriding it.
+     */
+    static constexpr bool can_defer_init()
+    {
+        return false;
+    }
 };
 
 /**
@@ -99,5 +108,10 @@ class per_output_plugin_t : public wf::plugin_interface_t,
     {
         this->fini_output_tracking();
     }
+
+    bool can_defer_init() const override
+    {
+        return ConcretePluginType::can_defer_init();
+    }
 };
 }
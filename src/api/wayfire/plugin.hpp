@@ -91,6 +91,24 @@ class plugin_interface_t
         return 0;
     }
 
+    /**
+     * A plugin can indicate that it only reacts to bindings (or other user input), and therefore does not
+     * need to be initialized before Wayfire has shown its first frame.
+     *
+     * If core/lazy_plugin_init is enabled, such plugins are initialized shortly after the first frame on
+     * startup, which shortens the time until the first frame. They are initialized earlier if a key,
+     * button or touch event arrives before that, but not lazily on the first use of their own bindings.
+     * Plugins loaded later (for example after a change of the plugin list) are always initialized
+     * immediately.
+     *
+     * Plugins based on per_output_plugin_t declare this in their per-output class instead, see
+     * per_output_plugin_instance_t::can_defer_init().
+     */
+    virtual bool can_defer_init() const
+    {
+        return false;
+    }
+
     virtual ~plugin_interface_t() = default;
 };
 }
@@ -105,7 +123,7 @@ class plugin_interface_t
 using wayfire_plugin_load_func = wf::plugin_interface_t * (*)();
 
 /** The version of Wayfire's API/ABI */
-constexpr uint32_t WAYFIRE_API_ABI_VERSION = 2024'08'26;
+constexpr uint32_t WAYFIRE_API_ABI_VERSION = 2026'10'18;
 
 /**
  * Each plugin must also provide a function which returns the Wayfire API/ABI
@@ -3,9 +3,18 @@
 #include <wayfire/output.hpp>
 #include <wayfire/object.hpp>
 #include <wayfire/region.hpp>
+#include <chrono>
+#include <unordered_map>
+#include <vector>
 
 namespace wf
 {
+namespace scene
+{
+class node_t;
+using node_ptr = std::shared_ptr<node_t>;
+}
+
 /* Effect hooks provide the plugins with a way to execute custom code
  * at certain parts of the repaint cycle */
 using effect_hook_t = std::function<void ()>;
@@ -45,6 +54,57 @@ enum output_effect_type_t
 using post_hook_t = std::function<void (const wf::framebuffer_t& source,
     const wf::framebuffer_t& destination)>;
 
+/**
+ * The state of a single animation frame on an output, shared by all animations running on it.
+ */
+struct animation_frame_t
+{
+    /** The output the animations are running on. */
+    wf::output_t *output;
+
+    /**
+     * The predicted time when the frame will be shown on the output. All animations on the output should
+     * use it instead of reading the clock themselves, so that they stay in sync with each other.
+     */
+    std::chrono::steady_clock::time_point presentation_time;
+
+    /**
+     * Whether the output is currently not being shown, for example because it is disabled or inhibited.
+     * Animations should jump to their end state (or pause, if they have no end) in this case, as frames are
+     * not painted and updates arrive only rarely. Animations of occluded nodes on a visible output are not
+     * suspended.
+     */
+    bool suspended = false;
+
+    /**
+     * Indicate that an animation is about to change the given node.
+     *
+     * Instead of damaging the node immediately, the damage is collected and emitted once for each node
+     * after all animations on the output have been updated. It covers the bounding box of the node at the
+     * time of the first call in this frame and at the end of the frame.
+     */
+    void damage_node(const wf::scene::node_ptr& node);
+
+    /**
+     * Emit the collected damage for the given node immediately. Useful when the node is about to be
+     * removed from the scenegraph, for example when an animation ends.
+     */
+    void flush_damage(const wf::scene::node_ptr& node);
+
+    /**
+     * Emit the collected damage for all nodes. Called by the render manager after updating all animations.
+     */
+    void flush_damage();
+
+  private:
+    std::unordered_map<wf::scene::node_ptr, wf::region_t> damaged_nodes;
+};
+
+/**
+ * Animation hooks are called once per frame, before any effect hooks, on the output they were added to.
+ */
+using animation_hook_t = std::function<void (animation_frame_t&)>;
+
 /**
  * The frame-done signal is emitted on an output when the frame has been completed (regardless of whether new
  * content was painted or not).
@@ -102,6 +162,23 @@ class render_manager
      */
     void rem_effect(effect_hook_t *hook);
 
+    /**
+     * Add an animation hook. Frames are scheduled automatically as long as there are animation hooks on the
+     * output, and their damage is batched, see animation_frame_t.
+     *
+     * While the output is disabled, the hooks are still called periodically with suspended set, so that
+     * animations can finish.
+     *
+     * @param hook The hook callback
+     */
+    void add_animation(animation_hook_t *hook);
+
+    /**
+     * Remove an animation hook. No-op if the hook wasn't really added.
+     * @param hook The hook callback to be removed
+     */
+    void rem_animation(animation_hook_t *hook);
+
     /**
      * Add a new post hook.
      *
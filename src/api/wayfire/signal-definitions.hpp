@@ -4,6 +4,8 @@
 #include "wayfire/view.hpp"
 #include "wayfire/output.hpp"
 #include "wayfire/seat.hpp"
+#include <set>
+#include <string>
 
 /**
  * Documentation of signals emitted from core components.
@@ -193,7 +195,29 @@ struct touch_focus_changed_signal
  * when: When the config file is reloaded
  */
 struct reload_config_signal
-{};
+{
+    /**
+     * The config sections in which at least one option was changed, added or removed.
+     * An empty set means that the changes were not tracked, and any option may have changed.
+     */
+    std::set<std::string> changed_sections;
+
+    /**
+     * @return Whether options in the given section, or in any of its per-output or
+     *   per-device sections (named "<section>:<name>"), may have changed.
+     */
+    bool may_have_changed(const std::string& section) const
+    {
+        if (changed_sections.empty() || changed_sections.count(section))
+        {
+            return true;
+        }
+
+        auto prefix = section + ":";
+        auto it     = changed_sections.lower_bound(prefix);
+        return (it != changed_sections.end()) && (it->compare(0, prefix.size(), prefix) == 0);
+    }
+};
 
 /**
  * on: core
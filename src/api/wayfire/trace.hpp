@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <wayfire/debug.hpp>
+
+/**
+ * A lightweight tracing facility for finding out where time is spent, for example during startup.
+ *
+ * Recording is enabled with the --trace command line option, which writes the recorded events to a file in
+ * the Chrome trace event format. The file can be opened with chrome://tracing or https://ui.perfetto.dev.
+ * Independently of the trace file, spans and instant events are printed to the log if `-d trace` is given.
+ *
+ * When neither is enabled, recording an event costs two checks of global flags.
+ */
+namespace wf
+{
+namespace trace
+{
+using trace_clock = std::chrono::steady_clock;
+
+namespace detail
+{
+/** Whether a trace file is open, see start(). */
+extern std::atomic<bool> recording;
+}
+
+/**
+ * @return Whether trace events are currently being recorded to a file.
+ */
+inline bool is_recording()
+{
+    return detail::recording.load(std::memory_order_relaxed);
+}
+
+/**
+ * @return Whether trace events are currently being recorded to a file or to the log.
+ */
+inline bool is_enabled()
+{
+    return is_recording() || wf::log::enabled_categories[(size_t)wf::log::logging_category::TRACE];
+}
+
+/**
+ * Start recording trace events to the given file.
+ *
+ * Timestamps in the file are relative to the start of the recording. The first event is an instant event
+ * named "trace start" at timestamp 0, whose "steady_clock_us" argument is the start time on
+ * std::chrono::steady_clock, so that other processes can relate their own measurements to the trace.
+ *
+ * @return Whether the file could be opened.
+ */
+bool start(const std::string& path);
+
+/**
+ * Stop recording trace events and finish the trace file. No-op if tracing is not enabled.
+ */
+void stop();
+
+/**
+ * Record a span which started and ended at the given times. Usually, scope_t should be used instead.
+ */
+void record_span(std::string_view name, trace_clock::time_point start, trace_clock::time_point end);
+
+/**
+ * Record the value of a counter at the current time.
+ */
+void record_counter(std::string_view name, int64_t value);
+
+/**
+ * Record an event without a duration at the current time.
+ */
+void record_instant(std::string_view name);
+
+/**
+ * A span which lasts from the construction of the object until its destruction.
+ * The name is not copied, so it must outlive the object.
+ */
+class scope_t
+{
+  public:
+    scope_t(std::string_view name)
+    {
+        if (is_enabled())
+        {
+            this->name   = name;
+            this->start  = trace_clock::now();
+            this->active = true;
+        }
+    }
+
+    ~scope_t()
+    {
+        if (active)
+        {
+            record_span(name, start, trace_clock::now());
+        }
+    }
+
+    scope_t(const scope_t&) = delete;
+    scope_t(scope_t&&) = delete;
+    scope_t& operator =(const scope_t&) = delete;
+    scope_t& operator =(scope_t&&) = delete;
+
+  private:
+    std::string_view name;
+    trace_clock::time_point start;
+    bool active = false;
+};
+}
+}
+
+#define WF_TRACE_CONCAT_IMPL(a, b) a ## b
+#define WF_TRACE_CONCAT(a, b) WF_TRACE_CONCAT_IMPL(a, b)
+
+/** Record a span covering the rest of the current scope. */
+#define WF_TRACE_SCOPE(name) \
+    wf::trace::scope_t WF_TRACE_CONCAT(wf_trace_scope_, __LINE__){name}
+
+/** Record the value of a counter. The value is not evaluated if tracing is disabled. */
+#define WF_TRACE_COUNTER(name, value) \
+    do { \
+        if (wf::trace::is_enabled()) \
+        { \
+            wf::trace::record_counter(name, value); \
+        } \
+    } while (0)
+
+/** Record an instant event. */
+#define WF_TRACE_INSTANT(name) \
+    do { \
+        if (wf::trace::is_enabled()) \
+        { \
+            wf::trace::record_instant(name); \
+        } \
+    } while (0)
@@ -15,6 +15,22 @@
 namespace wf
 {
 #if WF_HAS_XWAYLAND
+/**
+ * Counters for the configure requests of Xwayland views.
+ *
+ * Configure requests of mapped views are coalesced: only the latest request received before the view's
+ * output paints its next frame is handled.
+ */
+struct xwayland_configure_stats_t
+{
+    /** The number of configure requests received from the client(s). */
+    uint64_t requests = 0;
+    /** The number of requests which were dropped because a later request replaced them. */
+    uint64_t coalesced = 0;
+    /** The number of handled requests which replaced at least one earlier request. */
+    uint64_t coalesced_batches = 0;
+};
+
 /**
  * A base class for views which base on a wlr_xwayland surface.
  * Contains the implementation of view_interface_t functions used in them.
@@ -38,10 +54,17 @@ class xwayland_view_base_t : public virtual wf::view_interface_t
     wlr_surface *get_keyboard_focus_surface() override;
     bool is_focusable() const override;
 
+    /** The configure request counters of this view. */
+    xwayland_configure_stats_t& get_configure_stats();
+
+    /** The configure request counters of all Xwayland views since startup. */
+    static xwayland_configure_stats_t& get_total_configure_stats();
+
   protected:
     std::string title, app_id;
     wlr_xwayland_surface *xw;
     bool kb_focus_enabled = true;
+    xwayland_configure_stats_t configure_stats;
 
     /** Used by view implementations when the app id changes */
     void handle_app_id_changed(std::string new_app_id);
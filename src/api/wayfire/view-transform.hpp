@@ -8,6 +8,7 @@
 #include "wayfire/scene.hpp"
 #include <memory>
 #include <wayfire/opengl.hpp>
+#include <wayfire/framebuffer-pool.hpp>
 
 namespace wf
 {
@@ -28,6 +29,41 @@ class zero_copy_texturable_node_t
     }
 };
 
+/**
+ * An interface for transformer nodes whose effect is just an affine 2D transformation and an opacity
+ * multiplier. Chains of such transformers can be rendered in a single pass from the texture of the
+ * innermost node, without rendering each transformer to an intermediate buffer, see
+ * transformer_render_instance_t::fused_texture().
+ */
+class affine_transformer_node_t
+{
+  public:
+    virtual ~affine_transformer_node_t() = default;
+
+    /**
+     * Get the matrix which maps points from the coordinate system of the node's children to the
+     * coordinate system of the node's parent.
+     */
+    virtual glm::mat4 get_affine_transform() = 0;
+
+    /**
+     * Get the multiplier for the opacity of the node's children.
+     */
+    virtual float get_alpha_multiplier()
+    {
+        return 1.0f;
+    }
+
+    /**
+     * Check whether the node may be skipped when fusing a chain of transformers. This is the case only
+     * if the node's render instance does nothing but apply get_affine_transform() and
+     * get_alpha_multiplier(). Subclasses of a fusible transformer which render differently (with a
+     * custom shader, additional content, etc.) must not be fused, so implementations which may be
+     * subclassed should compare the dynamic type of the node with their own type.
+     */
+    virtual bool can_fuse() = 0;
+};
+
 class opaque_region_node_t
 {
   public:
@@ -72,7 +108,7 @@ class transformer_base_node_t : public scene::floating_inner_node_t
 
         OpenGL::render_begin();
         inner_content.scale = scale;
-        if (inner_content.allocate(target_width, target_height))
+        if (wf::get_framebuffer_pool().allocate(inner_content, target_width, target_height))
         {
             cached_damage |= bbox;
         }
@@ -99,7 +135,7 @@ class transformer_base_node_t : public scene::floating_inner_node_t
             // the zero-copy path and we do not need an auxiliary
             // buffer to render to.
             OpenGL::render_begin();
-            inner_content.release();
+            wf::get_framebuffer_pool().release(inner_content);
             OpenGL::render_end();
         }
     }
@@ -176,6 +212,81 @@ class transformer_render_instance_t : public render_instance_t
         return self->get_updated_contents(self->get_children_bounding_box(), scale, children);
     }
 
+    /** The result of fused_texture(). */
+    struct fused_texture_t
+    {
+        // The texture of the innermost node.
+        wf::texture_t texture;
+        // The geometry of the texture, in the coordinate system of the innermost transformer's children.
+        wf::geometry_t geometry;
+        // The combined transformation of the transformers below this node.
+        glm::mat4 transform = glm::mat4(1.0);
+        // The combined alpha multiplier of the transformers below this node.
+        float alpha = 1.0f;
+    };
+
+    /**
+     * Try to skip the intermediate buffers of a chain of affine transformers below this node.
+     *
+     * If the children of this node are a chain of transformers implementing affine_transformer_node_t
+     * which ends in a node supporting zero-copy texture generation, the texture of that node is returned,
+     * together with the combined transformation and alpha of the transformers in-between. Applying them
+     * and then this node's transformation gives the same result as get_texture(), without a single extra
+     * render pass.
+     *
+     * @return The fused texture, or nothing if the chain cannot be fused.
+     */
+    std::optional<fused_texture_t> fused_texture()
+    {
+        fused_texture_t result;
+        std::vector<transformer_base_node_t*> fused_nodes;
+        node_t *node = self.get();
+        while (node->get_children().size() == 1)
+        {
+            auto child = node->get_children().front().get();
+            if (auto zcopy = dynamic_cast<zero_copy_texturable_node_t*>(child))
+            {
+                if (fused_nodes.empty())
+                {
+                    // Nothing to fuse, get_texture() does the same.
+                    return {};
+                }
+
+                auto tex = zcopy->to_texture();
+                if (!tex)
+                {
+                    return {};
+                }
+
+                result.texture  = *tex;
+                result.geometry = child->get_bounding_box();
+
+                // The intermediate buffers are not needed while the chain is fused.
+                self->release_buffers();
+                for (auto& fused : fused_nodes)
+                {
+                    fused->release_buffers();
+                }
+
+                return result;
+            }
+
+            auto affine = dynamic_cast<affine_transformer_node_t*>(child);
+            auto transformer = dynamic_cast<transformer_base_node_t*>(child);
+            if (!affine || !transformer || !affine->can_fuse())
+            {
+                return {};
+            }
+
+            result.transform = result.transform * affine->get_affine_transform();
+            result.alpha    *= affine->get_alpha_multiplier();
+            fused_nodes.push_back(transformer);
+            node = child;
+        }
+
+        return {};
+    }
+
     void presentation_feedback(wf::output_t *output) override
     {
         for (auto& ch : children)
@@ -371,7 +482,7 @@ class transform_manager_node_t : public wf::scene::floating_inner_node_t
 /**
  * A simple transformer which supports 2D transformations on a view.
  */
-class view_2d_transformer_t : public transformer_base_node_t
+class view_2d_transformer_t : public transformer_base_node_t, public affine_transformer_node_t
 {
   public:
     float scale_x = 1.0f;
@@ -387,6 +498,10 @@ class view_2d_transformer_t : public transformer_base_node_t
     float alpha = 1.0f;
 
     view_2d_transformer_t(wayfire_view view);
+    glm::mat4 get_affine_transform() override;
+    float get_alpha_multiplier() override;
+    // Only plain 2D transformers can be fused, subclasses usually have their own render instance.
+    bool can_fuse() override;
     wf::pointf_t to_local(const wf::pointf_t& point) override;
     wf::pointf_t to_global(const wf::pointf_t& point) override;
     std::string stringify() const override;
@@ -181,6 +181,14 @@ class view_interface_t : public wf::signal::provider_t, public wf::object_base_t
         return false;
     }
 
+    /**
+     * Get the version of the view's basic properties: app-id, title, mapped, minimized and activated state.
+     * It changes right before the signals announcing a change of one of them are emitted, so it can be used
+     * to cache values derived from these properties, even in handlers of those signals. Versions are unique
+     * across all views.
+     */
+    uint64_t get_properties_version() const;
+
     virtual ~view_interface_t();
 
     class view_priv_impl;
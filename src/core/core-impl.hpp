@@ -13,6 +13,7 @@ namespace wf
 class seat_t;
 class input_manager_t;
 class input_method_relay;
+class worker_pool_t;
 class compositor_core_impl_t : public compositor_core_t
 {
   public:
@@ -23,6 +24,9 @@ class compositor_core_impl_t : public compositor_core_t
     std::unique_ptr<input_method_relay> im_relay;
     std::unique_ptr<plugin_manager_t> plugin_mgr;
 
+    /** Background threads for work which does not touch compositor state, like image decoding. */
+    std::unique_ptr<worker_pool_t> worker_pool;
+
     /**
      * Initialize the compositor core.
      * Called only by main().
@@ -12,6 +12,7 @@
 #include "wayfire/bindings-repository.hpp"
 #include "wayfire/util.hpp"
 #include <memory>
+#include <algorithm>
 
 #include "plugin-loader.hpp"
 #include "seat/tablet.hpp"
@@ -25,6 +26,7 @@
 #include <wayfire/img.hpp>
 #include <wayfire/output.hpp>
 #include <wayfire/util/log.hpp>
+#include <wayfire/trace.hpp>
 #include <wayfire/output-layout.hpp>
 #include <wayfire/workspace-set.hpp>
 #include <wayfire/signal-definitions.hpp>
@@ -33,6 +35,7 @@
 #include "wayfire/unstable/wlr-surface-controller.hpp"
 #include "wayfire/scene-input.hpp"
 #include "opengl-priv.hpp"
+#include "worker-pool.hpp"
 #include "seat/input-manager.hpp"
 #include "seat/input-method-relay.hpp"
 #include "seat/touch.hpp"
@@ -77,6 +80,7 @@ struct wlr_idle_inhibitor_t : public wf::idle_inhibitor_t
 
 void wf::compositor_core_impl_t::init()
 {
+    WF_TRACE_SCOPE("core init");
     this->scene_root = std::make_shared<scene::root_node_t>();
     this->tx_manager = std::make_unique<txn::transaction_manager_t>();
     this->default_wm = std::make_unique<wf::window_manager_t>();
@@ -212,6 +216,8 @@ void wf::compositor_core_impl_t::init()
     wlr_single_pixel_buffer_manager_v1_create(display);
 
     this->bindings = std::make_unique<bindings_repository_t>();
+    this->worker_pool = std::make_unique<worker_pool_t>(ev_loop,
+        std::clamp<int>(std::thread::hardware_concurrency() / 2, 1, 4));
     image_io::init();
     OpenGL::init();
     this->state = compositor_state_t::START_BACKEND;
@@ -219,12 +225,17 @@ void wf::compositor_core_impl_t::init()
 
 void wf::compositor_core_impl_t::post_init()
 {
+    WF_TRACE_SCOPE("core post_init");
     discard_command_output.load_option("workarounds/discard_command_output");
 
     core_backend_started_signal backend_started_ev;
     this->emit(&backend_started_ev);
     this->state = compositor_state_t::RUNNING;
-    plugin_mgr  = std::make_unique<wf::plugin_manager_t>();
+    {
+        WF_TRACE_SCOPE("plugins");
+        plugin_mgr = std::make_unique<wf::plugin_manager_t>();
+    }
+
     this->bindings->reparse_extensions();
 
     // Move pointer to the middle of the leftmost, topmost output
@@ -290,6 +301,8 @@ void wf::compositor_core_impl_t::fini()
     priv_output_layout_fini(output_layout.get());
     output_layout.reset();
     tx_manager.reset();
+    image_io::fini();
+    worker_pool.reset();
     OpenGL::fini();
     disconnect_signals();
     wl_display_destroy(static_core->display);
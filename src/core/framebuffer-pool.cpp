@@ -0,0 +1,182 @@
+#include <wayfire/framebuffer-pool.hpp>
+#include <wayfire/gpu-resources.hpp>
+#include <wayfire/option-wrapper.hpp>
+#include <wayfire/util.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <list>
+#include <unordered_map>
+
+/** Idle framebuffers which have not been used for this long are destroyed. */
+static constexpr auto IDLE_TIMEOUT = std::chrono::seconds(10);
+/** How often to check for expired idle framebuffers, in milliseconds. */
+static constexpr int TRIM_INTERVAL = 2500;
+
+static size_t get_buffer_size(int width, int height)
+{
+    return (size_t)std::max(width, 0) * std::max(height, 0) * 4;
+}
+
+class wf::framebuffer_pool_t::impl
+{
+  public:
+    struct entry_t
+    {
+        wf::framebuffer_t fb;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    // Idle framebuffers, the most recently used first.
+    std::list<entry_t> idle;
+    // The sizes of the framebuffers handed out by the pool, by framebuffer id.
+    std::unordered_map<GLuint, size_t> used;
+    stats_t stats;
+
+    wf::option_wrapper_t<int> budget{"core/framebuffer_pool_size"};
+    wf::wl_timer<true> trim_timer;
+
+    void destroy_last_idle()
+    {
+        auto& entry = idle.back();
+        stats.idle_buffers--;
+        stats.idle_bytes -= get_buffer_size(entry.fb.viewport_width, entry.fb.viewport_height);
+        entry.fb.release();
+        idle.pop_back();
+    }
+
+    void trim_to_budget()
+    {
+        const size_t max_bytes = (size_t)std::max((int)budget, 0) * 1024 * 1024;
+        while (!idle.empty() && (stats.idle_bytes > max_bytes))
+        {
+            destroy_last_idle();
+        }
+    }
+
+    void schedule_trim()
+    {
+        if (trim_timer.is_connected())
+        {
+            return;
+        }
+
+        trim_timer.set_timeout(TRIM_INTERVAL, [=] ()
+        {
+            auto now = std::chrono::steady_clock::now();
+            OpenGL::render_begin();
+            while (!idle.empty() && (now - idle.back().last_used >= IDLE_TIMEOUT))
+            {
+                destroy_last_idle();
+            }
+
+            OpenGL::render_end();
+            return !idle.empty();
+        });
+    }
+};
+
+wf::framebuffer_pool_t::framebuffer_pool_t()
+{
+    priv = std::make_unique<impl>();
+}
+
+wf::framebuffer_pool_t::~framebuffer_pool_t() = default;
+
+bool wf::framebuffer_pool_t::allocate(wf::framebuffer_t& fb, int width, int height)
+{
+    const void *caller = __builtin_return_address(0);
+    if ((fb.fb != (GLuint)-1) && (fb.viewport_width == width) && (fb.viewport_height == height))
+    {
+        return false;
+    }
+
+    release(fb);
+
+    auto it = std::find_if(priv->idle.begin(), priv->idle.end(), [&] (const impl::entry_t& entry)
+    {
+        return (entry.fb.viewport_width == width) && (entry.fb.viewport_height == height);
+    });
+
+    const size_t size = get_buffer_size(width, height);
+    if (it != priv->idle.end())
+    {
+        // Assign only the framebuffer part, keep the rest of render targets as it is.
+        fb = it->fb;
+        priv->idle.erase(it);
+        priv->stats.idle_buffers--;
+        priv->stats.idle_bytes -= size;
+        priv->stats.reused++;
+    } else
+    {
+        fb.allocate(width, height);
+        priv->stats.created++;
+    }
+
+    // Attribute the buffer to the user of the pool, not to the pool itself.
+    wf::gpu_resources::set_owner(wf::gpu_resources::resource_type_t::TEXTURE, fb.tex, caller);
+    wf::gpu_resources::set_owner(wf::gpu_resources::resource_type_t::FRAMEBUFFER, fb.fb, caller);
+
+    priv->used[fb.fb] = size;
+    priv->stats.used_buffers++;
+    priv->stats.used_bytes += size;
+    return true;
+}
+
+void wf::framebuffer_pool_t::release(wf::framebuffer_t& fb)
+{
+    if (fb.fb == (GLuint)-1)
+    {
+        return;
+    }
+
+    auto it = priv->used.find(fb.fb);
+    if (it == priv->used.end())
+    {
+        // Not allocated from the pool.
+        fb.release();
+        return;
+    }
+
+    priv->stats.used_buffers--;
+    priv->stats.used_bytes -= it->second;
+    priv->used.erase(it);
+
+    // Idle buffers belong to the pool, i.e. to Wayfire itself.
+    wf::gpu_resources::set_owner(wf::gpu_resources::resource_type_t::TEXTURE, fb.tex,
+        (const void*)&get_framebuffer_pool);
+    wf::gpu_resources::set_owner(wf::gpu_resources::resource_type_t::FRAMEBUFFER, fb.fb,
+        (const void*)&get_framebuffer_pool);
+    priv->idle.push_front({fb, std::chrono::steady_clock::now()});
+    priv->stats.idle_buffers++;
+    priv->stats.idle_bytes += get_buffer_size(fb.viewport_width, fb.viewport_height);
+    fb.reset();
+
+    priv->trim_to_budget();
+    if (!priv->idle.empty())
+    {
+        priv->schedule_trim();
+    }
+}
+
+void wf::framebuffer_pool_t::clear()
+{
+    while (!priv->idle.empty())
+    {
+        priv->destroy_last_idle();
+    }
+
+    priv->trim_timer.disconnect();
+}
+
+wf::framebuffer_pool_t::stats_t wf::framebuffer_pool_t::get_stats() const
+{
+    return priv->stats;
+}
+
+wf::framebuffer_pool_t& wf::get_framebuffer_pool()
+{
+    // Never destroyed: by the time static objects are destroyed, the GL context and the event loop are gone.
+    static framebuffer_pool_t *pool = new framebuffer_pool_t();
+    return *pool;
+}
@@ -0,0 +1,137 @@
+#include <wayfire/gpu-resources.hpp>
+#include <wayfire/util/log.hpp>
+#include <wayfire/debug.hpp>
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <unordered_map>
+
+namespace
+{
+using resource_key_t = std::pair<wf::gpu_resources::resource_type_t, GLuint>;
+
+struct resource_key_hash_t
+{
+    size_t operator ()(const resource_key_t& key) const
+    {
+        return std::hash<uint64_t>{}(((uint64_t)key.first << 32) | key.second);
+    }
+};
+
+std::unordered_map<resource_key_t, wf::gpu_resources::resource_t, resource_key_hash_t> resources;
+
+/**
+ * Find the name of the module containing the given address: "libblur.so" becomes "blur", the Wayfire
+ * executable itself is "wayfire".
+ * Names are cached by path rather than by load address, since a plugin which is unloaded and another one
+ * loaded later may end up at the same address.
+ */
+std::string get_module_name(const void *address)
+{
+    static std::unordered_map<std::string, std::string> module_names;
+
+    Dl_info info;
+    if (!address || !dladdr(address, &info) || !info.dli_fname)
+    {
+        return "unknown";
+    }
+
+    auto it = module_names.find(info.dli_fname);
+    if (it != module_names.end())
+    {
+        return it->second;
+    }
+
+    std::string name = info.dli_fname;
+    name = name.substr(name.find_last_of('/') + 1);
+    if (name.rfind("lib", 0) == 0)
+    {
+        name = name.substr(3);
+    }
+
+    auto ext = name.find(".so");
+    if (ext != std::string::npos)
+    {
+        name = name.substr(0, ext);
+    }
+
+    module_names[info.dli_fname] = name;
+    return name;
+}
+
+const char *type_to_string(wf::gpu_resources::resource_type_t type)
+{
+    return (type == wf::gpu_resources::resource_type_t::TEXTURE) ? "texture" : "framebuffer";
+}
+
+void track(wf::gpu_resources::resource_type_t type, GLuint id, int width, int height, const void *caller)
+{
+    auto& res = resources[{type, id}];
+    const bool is_new = res.owner.empty();
+    if (is_new)
+    {
+        res.type  = type;
+        res.id    = id;
+        res.owner = get_module_name(caller);
+    }
+
+    res.width  = width;
+    res.height = height;
+    res.bytes  = (type == wf::gpu_resources::resource_type_t::TEXTURE) ?
+        (size_t)std::max(width, 0) * std::max(height, 0) * 4 : 0;
+    LOGC(GPU, is_new ? "Allocated " : "Resized ", type_to_string(type), " ", id, " (",
+        width, "x", height, ") for ", res.owner);
+}
+
+void untrack(wf::gpu_resources::resource_type_t type, GLuint id)
+{
+    auto it = resources.find({type, id});
+    if (it != resources.end())
+    {
+        LOGC(GPU, "Freed ", type_to_string(type), " ", id, " (", it->second.width, "x",
+            it->second.height, ") of ", it->second.owner);
+        resources.erase(it);
+    }
+}
+}
+
+void wf::gpu_resources::track_texture(GLuint tex, int width, int height, const void *caller)
+{
+    track(resource_type_t::TEXTURE, tex, width, height, caller);
+}
+
+void wf::gpu_resources::track_framebuffer(GLuint fb, const void *caller)
+{
+    track(resource_type_t::FRAMEBUFFER, fb, 0, 0, caller);
+}
+
+void wf::gpu_resources::set_owner(resource_type_t type, GLuint id, const void *caller)
+{
+    auto it = resources.find({type, id});
+    if (it != resources.end())
+    {
+        it->second.owner = get_module_name(caller);
+    }
+}
+
+void wf::gpu_resources::untrack_texture(GLuint tex)
+{
+    untrack(resource_type_t::TEXTURE, tex);
+}
+
+void wf::gpu_resources::untrack_framebuffer(GLuint fb)
+{
+    untrack(resource_type_t::FRAMEBUFFER, fb);
+}
+
+std::vector<wf::gpu_resources::resource_t> wf::gpu_resources::get_resources()
+{
+    std::vector<resource_t> result;
+    result.reserve(resources.size());
+    for (auto& [_, res] : resources)
+    {
+        result.push_back(res);
+    }
+
+    return result;
+}
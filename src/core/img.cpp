@@ -1,7 +1,10 @@
 #include <GLES2/gl2.h>
 #include <wayfire/util/log.hpp>
 #include "wayfire/img.hpp"
+#include "wayfire/gpu-resources.hpp"
 #include "wayfire/opengl.hpp"
+#include "core-impl.hpp"
+#include "worker-pool.hpp"
 
 #include <config.h>
 
@@ -9,12 +12,18 @@
     #include <png.h>
     #include <jpeglib.h>
     #include <jerror.h>
+    #include <setjmp.h>
 #endif
 
 #include <stdint.h>
 #include <unistd.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
 #include <cstdio>
+#include <mutex>
 #include <unordered_map>
 #include <functional>
 
@@ -22,16 +31,26 @@
 
 namespace image_io
 {
-using Loader = std::function<bool (const char*, GLuint)>;
-using Writer = std::function<void (const char*name, uint8_t*pixels, unsigned long,
-    unsigned long, bool)>;
+using Decoder = std::function<bool (const uint8_t *data, size_t size, decoded_image_t& image)>;
+using Writer  = writer_t;
 namespace
 {
-std::unordered_map<std::string, Loader> loaders;
+/* The registered codecs. Decoders are looked up from worker threads (see decode_file_async()) and
+ * writers can be registered at any time, so both are guarded by codecs_mutex. Lookups copy the codec
+ * out, so that it is not used under the lock. */
+std::mutex codecs_mutex;
+std::unordered_map<std::string, Decoder> decoders;
 std::unordered_map<std::string, Writer> writers;
+
+Writer find_writer(const std::string& type)
+{
+    std::lock_guard<std::mutex> lock(codecs_mutex);
+    auto it = writers.find(type);
+    return (it == writers.end()) ? Writer{} : it->second;
+}
 }
 
-bool load_data_as_cubemap(unsigned char *data, int width, int height, int channels)
+bool load_data_as_cubemap(const unsigned char *data, int width, int height, int channels)
 {
     width  /= 4;
     height /= 3;
@@ -121,42 +140,59 @@ bool load_data_as_cubemap(unsigned char *data, int width, int height, int channe
 #ifdef BUILD_WITH_IMAGEIO
 /* All backend functions are taken from the internet.
  * If you want to be credited, contact me */
-bool texture_from_png(const char *filename, GLuint target)
+struct png_memory_reader_t
+{
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+};
+
+void png_read_from_memory(png_structp png, png_bytep out, png_size_t length)
+{
+    auto reader = (png_memory_reader_t*)png_get_io_ptr(png);
+    if (length > reader->size - reader->offset)
+    {
+        png_error(png, "unexpected end of file");
+    }
+
+    memcpy(out, reader->data + reader->offset, length);
+    reader->offset += length;
+}
+
+bool decode_png(const uint8_t *data, size_t size, decoded_image_t& image)
 {
-    FILE *fp = fopen(filename, "rb");
-    int width, height;
-    png_byte color_type;
-    png_byte bit_depth;
-    png_bytep *row_pointers;
+    if ((size < 8) || png_sig_cmp(data, 0, 8))
+    {
+        return false;
+    }
 
     png_structp png =
         png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!png)
     {
-        fclose(fp);
         return false;
     }
 
     png_infop infos = png_create_info_struct(png);
     if (!infos)
     {
-        fclose(fp);
+        png_destroy_read_struct(&png, NULL, NULL);
         return false;
     }
 
+    png_memory_reader_t reader{data, size, 0};
+    std::vector<png_bytep> row_pointers;
     if (setjmp(png_jmpbuf(png)))
     {
-        fclose(fp);
+        png_destroy_read_struct(&png, &infos, NULL);
         return false;
     }
 
-    png_init_io(png, fp);
+    png_set_read_fn(png, &reader, png_read_from_memory);
     png_read_info(png, infos);
 
-    width  = png_get_image_width(png, infos);
-    height = png_get_image_height(png, infos);
-    color_type = png_get_color_type(png, infos);
-    bit_depth  = png_get_bit_depth(png, infos);
+    png_byte color_type = png_get_color_type(png, infos);
+    png_byte bit_depth  = png_get_bit_depth(png, infos);
 
     if (bit_depth == 16)
     {
@@ -195,49 +231,32 @@ bool texture_from_png(const char *filename, GLuint target)
 
     png_read_update_info(png, infos);
 
-    row_pointers = new png_bytep[height];
-    png_byte *data = new png_byte[height * png_get_rowbytes(png, infos)];
-
-    for (int i = 0; i < height; i++)
-    {
-        row_pointers[i] = data + i * png_get_rowbytes(png, infos);
-    }
+    image.width    = png_get_image_width(png, infos);
+    image.height   = png_get_image_height(png, infos);
+    image.channels = png_get_channels(png, infos);
 
-    png_read_image(png, row_pointers);
-
-    if (target == GL_TEXTURE_CUBE_MAP)
+    size_t stride = png_get_rowbytes(png, infos);
+    image.pixels.resize(stride * image.height);
+    row_pointers.resize(image.height);
+    for (int i = 0; i < image.height; i++)
     {
-        if (!load_data_as_cubemap(data, width, height,
-            png_get_channels(png, infos)))
-        {
-            png_destroy_read_struct(&png, &infos, NULL);
-            delete[] row_pointers;
-            delete[] data;
-            fclose(fp);
-            return false;
-        }
-    } else if (target == GL_TEXTURE_2D)
-    {
-        GL_CALL(glTexImage2D(target, 0, GL_RGBA, width, height, 0,
-            GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)data));
+        row_pointers[i] = image.pixels.data() + i * stride;
     }
 
+    png_read_image(png, row_pointers.data());
     png_destroy_read_struct(&png, &infos, NULL);
-    delete[] row_pointers;
-    delete[] data;
-
-    fclose(fp);
 
     return true;
 }
 
-void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert)
+bool texture_to_png(const char *name, uint8_t *pixels, unsigned long w, unsigned long h,
+    bool invert)
 {
     png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr,
         nullptr, nullptr);
     if (!png)
     {
-        return;
+        return false;
     }
 
     png_infop infot = png_create_info_struct(png);
@@ -245,7 +264,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     {
         png_destroy_write_struct(&png, &infot);
 
-        return;
+        return false;
     }
 
     FILE *fp = fopen(name, "wb");
@@ -253,7 +272,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     {
         png_destroy_write_struct(&png, &infot);
 
-        return;
+        return false;
     }
 
     png_init_io(png, fp);
@@ -267,7 +286,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
         fclose(fp);
         png_destroy_write_struct(&png, &infot);
 
-        return;
+        return false;
     }
 
     png_set_PLTE(png, infot, palette, PNG_MAX_PALETTE_LENGTH);
@@ -275,7 +294,7 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
     png_set_packing(png);
 
     png_bytepp rows = (png_bytepp)png_malloc(png, h * sizeof(png_bytep));
-    for (int i = 0; i < h; ++i)
+    for (unsigned long i = 0; i < h; ++i)
     {
         if (invert)
         {
@@ -293,87 +312,412 @@ void texture_to_png(const char *name, uint8_t *pixels, int w, int h, bool invert
 
     fclose(fp);
     png_free(png, rows);
+
+    return true;
 }
 
-bool texture_from_jpeg(const char *FileName, GLuint target)
+struct jpeg_error_handler_t
 {
-    unsigned long data_size;
-    unsigned char *rowptr[1];
-    unsigned char *jdata;
-    struct jpeg_decompress_struct infot;
-    struct jpeg_error_mgr err;
+    jpeg_error_mgr mgr;
+    jmp_buf jump;
+};
 
-    std::FILE *file = fopen(FileName, "rb");
-    infot.err = jpeg_std_error(&err);
-    jpeg_create_decompress(&infot);
+void jpeg_error_exit(j_common_ptr info)
+{
+    // The default handler calls exit(), which is not quite what we want on a broken file.
+    (*info->err->output_message)(info);
+    longjmp(((jpeg_error_handler_t*)info->err)->jump, 1);
+}
 
-    if (!file)
-    {
-        LOGE("failed to read JPEG file ", FileName);
+bool decode_jpeg(const uint8_t *data, size_t size, decoded_image_t& image)
+{
+    struct jpeg_decompress_struct infot;
+    jpeg_error_handler_t err;
 
+    memset(&infot, 0, sizeof(infot));
+    infot.err = jpeg_std_error(&err.mgr);
+    err.mgr.error_exit = jpeg_error_exit;
+    if (setjmp(err.jump))
+    {
+        jpeg_destroy_decompress(&infot);
         return false;
     }
 
-    jpeg_stdio_src(&infot, file);
+    jpeg_create_decompress(&infot);
+    jpeg_mem_src(&infot, (unsigned char*)data, size);
     jpeg_read_header(&infot, TRUE);
+    infot.out_color_space = JCS_RGB;
     jpeg_start_decompress(&infot);
 
-    data_size = infot.output_width * infot.output_height * 3;
+    image.width    = infot.output_width;
+    image.height   = infot.output_height;
+    image.channels = 3;
 
-    jdata = new unsigned char [data_size];
+    size_t stride = 3 * infot.output_width;
+    image.pixels.resize(stride * infot.output_height);
     while (infot.output_scanline < infot.output_height)
     {
-        rowptr[0] = (unsigned char*)jdata + 3 * infot.output_width *
-            infot.output_scanline;
+        unsigned char *rowptr[1] = {image.pixels.data() + stride * infot.output_scanline};
         jpeg_read_scanlines(&infot, rowptr, 1);
     }
 
     jpeg_finish_decompress(&infot);
+    jpeg_destroy_decompress(&infot);
 
-    GLint width  = infot.output_width;
-    GLint height = infot.output_height;
+    return true;
+}
 
-    if (target == GL_TEXTURE_CUBE_MAP)
+#endif
+
+/* A QOI encoder, see https://qoiformat.org/qoi-specification.pdf
+ * It is lossless like png, but encodes an order of magnitude faster. */
+bool texture_to_qoi(const char *name, uint8_t *pixels, unsigned long w, unsigned long h,
+    bool invert)
+{
+    struct rgba_t
     {
-        if (!load_data_as_cubemap(jdata, width, height, 3))
+        uint8_t r, g, b, a;
+        bool operator ==(const rgba_t& other) const
         {
-            fclose(file);
-            delete[] jdata;
-            return false;
+            return r == other.r && g == other.g && b == other.b && a == other.a;
         }
-    } else if (target == GL_TEXTURE_2D)
+    };
+
+    std::vector<uint8_t> out;
+    out.reserve(14 + w * h * 2);
+    auto write_u32 = [&] (uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back((value >> shift) & 0xff);
+        }
+    };
+
+    out.insert(out.end(), {'q', 'o', 'i', 'f'});
+    write_u32(w);
+    write_u32(h);
+    out.push_back(4); // RGBA
+    out.push_back(0); // sRGB with linear alpha
+
+    rgba_t index[64] = {};
+    rgba_t prev{0, 0, 0, 255};
+    int run = 0;
+    for (unsigned long i = 0; i < h; i++)
+    {
+        const uint8_t *row = pixels + (invert ? (h - i - 1) : i) * w * 4;
+        for (unsigned long j = 0; j < w; j++)
+        {
+            rgba_t px{row[4 * j], row[4 * j + 1], row[4 * j + 2], row[4 * j + 3]};
+            if (px == prev)
+            {
+                if (++run == 62)
+                {
+                    out.push_back(0xc0 | (run - 1));
+                    run = 0;
+                }
+
+                continue;
+            }
+
+            if (run > 0)
+            {
+                out.push_back(0xc0 | (run - 1));
+                run = 0;
+            }
+
+            int hash = (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64;
+            if (index[hash] == px)
+            {
+                out.push_back(hash);
+            } else if (px.a == prev.a)
+            {
+                index[hash] = px;
+                int8_t dr = px.r - prev.r;
+                int8_t dg = px.g - prev.g;
+                int8_t db = px.b - prev.b;
+                int8_t dr_dg = dr - dg;
+                int8_t db_dg = db - dg;
+                if ((dr >= -2) && (dr <= 1) && (dg >= -2) && (dg <= 1) && (db >= -2) && (db <= 1))
+                {
+                    out.push_back(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                } else if ((dg >= -32) && (dg <= 31) && (dr_dg >= -8) && (dr_dg <= 7) &&
+                           (db_dg >= -8) && (db_dg <= 7))
+                {
+                    out.push_back(0x80 | (dg + 32));
+                    out.push_back((dr_dg + 8) << 4 | (db_dg + 8));
+                } else
+                {
+                    out.insert(out.end(), {0xfe, px.r, px.g, px.b});
+                }
+            } else
+            {
+                index[hash] = px;
+                out.insert(out.end(), {0xff, px.r, px.g, px.b, px.a});
+            }
+
+            prev = px;
+        }
+    }
+
+    if (run > 0)
+    {
+        out.push_back(0xc0 | (run - 1));
+    }
+
+    out.insert(out.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+
+    FILE *fp = fopen(name, "wb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    bool result = (fwrite(out.data(), 1, out.size(), fp) == out.size());
+    return (fclose(fp) == 0) && result;
+}
+
+/* The matching QOI decoder, so that files written by texture_to_qoi() can be loaded again. */
+bool decode_qoi(const uint8_t *data, size_t size, decoded_image_t& image)
+{
+    struct rgba_t
+    {
+        uint8_t r, g, b, a;
+    };
+
+    auto read_u32 = [&] (size_t offset)
+    {
+        return uint32_t(data[offset]) << 24 | uint32_t(data[offset + 1]) << 16 |
+               uint32_t(data[offset + 2]) << 8 | uint32_t(data[offset + 3]);
+    };
+
+    if ((size < 14 + 8) || memcmp(data, "qoif", 4))
+    {
+        return false;
+    }
+
+    uint32_t w = read_u32(4);
+    uint32_t h = read_u32(8);
+    if ((w == 0) || (h == 0) || (uint64_t(w) * h > (uint64_t(1) << 28)))
     {
-        GL_CALL(glTexImage2D(target, 0, GL_RGB, width, height, 0,
-            GL_RGB, GL_UNSIGNED_BYTE, jdata));
+        return false;
     }
 
-    fclose(file);
-    delete[] jdata;
+    image.width    = w;
+    image.height   = h;
+    image.channels = 4;
+    image.pixels.resize(size_t(w) * h * 4);
+
+    rgba_t index[64] = {};
+    rgba_t px{0, 0, 0, 255};
+    size_t pos = 14;
+    const size_t end = size - 8;
+    int run = 0;
+    for (size_t i = 0; i < image.pixels.size(); i += 4)
+    {
+        if (run > 0)
+        {
+            --run;
+        } else
+        {
+            if (pos >= end)
+            {
+                return false;
+            }
+
+            uint8_t op = data[pos++];
+            if (op == 0xfe)
+            {
+                if (pos + 3 > end)
+                {
+                    return false;
+                }
+
+                px.r = data[pos++];
+                px.g = data[pos++];
+                px.b = data[pos++];
+            } else if (op == 0xff)
+            {
+                if (pos + 4 > end)
+                {
+                    return false;
+                }
+
+                px = {data[pos], data[pos + 1], data[pos + 2], data[pos + 3]};
+                pos += 4;
+            } else if ((op & 0xc0) == 0x00)
+            {
+                px = index[op];
+            } else if ((op & 0xc0) == 0x40)
+            {
+                px.r += ((op >> 4) & 0x03) - 2;
+                px.g += ((op >> 2) & 0x03) - 2;
+                px.b += (op & 0x03) - 2;
+            } else if ((op & 0xc0) == 0x80)
+            {
+                if (pos >= end)
+                {
+                    return false;
+                }
+
+                int dg = (op & 0x3f) - 32;
+                uint8_t next = data[pos++];
+                px.r += dg - 8 + ((next >> 4) & 0x0f);
+                px.g += dg;
+                px.b += dg - 8 + (next & 0x0f);
+            } else
+            {
+                run = op & 0x3f;
+            }
+
+            index[(px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) % 64] = px;
+        }
+
+        image.pixels[i]     = px.r;
+        image.pixels[i + 1] = px.g;
+        image.pixels[i + 2] = px.b;
+        image.pixels[i + 3] = px.a;
+    }
 
     return true;
 }
 
-#endif
+namespace
+{
+/**
+ * A read-only memory mapping of a whole file. The decoders read the file straight from the page cache,
+ * without copying it to an intermediate buffer first.
+ */
+class mapped_file_t
+{
+  public:
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    struct stat info;
 
-bool load_from_file(std::string name, GLuint target)
+    mapped_file_t(const std::string& name)
+    {
+        int fd = open(name.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            return;
+        }
+
+        if ((fstat(fd, &info) == 0) && (info.st_size > 0))
+        {
+            void *mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+                data = (const uint8_t*)mapping;
+                size = info.st_size;
+            }
+        }
+
+        close(fd);
+    }
+
+    ~mapped_file_t()
+    {
+        if (data)
+        {
+            munmap((void*)data, size);
+        }
+    }
+
+    mapped_file_t(const mapped_file_t&) = delete;
+    mapped_file_t& operator =(const mapped_file_t&) = delete;
+};
+
+int64_t get_mtime_ns(const struct stat& info)
+{
+    return int64_t(info.st_mtim.tv_sec) * 1'000'000'000 + info.st_mtim.tv_nsec;
+}
+
+/**
+ * Decoded images, keyed by path. An entry is valid only as long as the modification time and the size
+ * of the file are the same as when it was decoded. When the cache grows too large, the least recently
+ * used images are dropped.
+ */
+class decoded_image_cache_t
+{
+  public:
+    std::shared_ptr<const decoded_image_t> lookup(const std::string& name, const struct stat& info)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(name);
+        if ((it == entries.end()) || (it->second.mtime != get_mtime_ns(info)) ||
+            (it->second.file_size != info.st_size))
+        {
+            return nullptr;
+        }
+
+        it->second.last_use = ++use_counter;
+        return it->second.image;
+    }
+
+    void insert(const std::string& name, const struct stat& info,
+        std::shared_ptr<const decoded_image_t> image)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = entries[name];
+        total_bytes -= entry.image ? entry.image->pixels.size() : 0;
+        entry.mtime     = get_mtime_ns(info);
+        entry.file_size = info.st_size;
+        entry.image     = image;
+        entry.last_use  = ++use_counter;
+        total_bytes    += image->pixels.size();
+
+        while ((total_bytes > MAX_CACHE_BYTES) && (entries.size() > 1))
+        {
+            auto oldest = std::min_element(entries.begin(), entries.end(), [] (auto& a, auto& b)
+            {
+                return a.second.last_use < b.second.last_use;
+            });
+
+            total_bytes -= oldest->second.image->pixels.size();
+            entries.erase(oldest);
+        }
+    }
+
+  private:
+    static constexpr size_t MAX_CACHE_BYTES = 64 << 20;
+
+    struct entry_t
+    {
+        int64_t mtime;
+        off_t file_size;
+        std::shared_ptr<const decoded_image_t> image;
+        uint64_t last_use;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, entry_t> entries;
+    uint64_t use_counter = 0;
+    size_t total_bytes   = 0;
+};
+
+decoded_image_cache_t decoded_cache;
+
+/* Find the decoder for the given file and check that the file exists.
+ * Returns an empty decoder on failure. */
+Decoder find_decoder(const std::string& name, struct stat& info)
 {
-    if (access(name.c_str(), F_OK) == -1)
+    if (stat(name.c_str(), &info) == -1)
     {
         if (!name.empty())
         {
-            LOGE(__func__, "() cannot access ", name);
+            LOGE("cannot access ", name);
         }
 
-        return false;
+        return nullptr;
     }
 
     int len = name.length();
     if ((len < 4) || (name[len - 4] != '.'))
     {
-        LOGE(
-            "load_from_file() called with file without extension or with invalid extension!");
+        LOGE("Cannot load image file without extension or with invalid extension!");
 
-        return false;
+        return nullptr;
     }
 
     auto ext = name.substr(len - 3, 3);
@@ -382,29 +726,159 @@ bool load_from_file(std::string name, GLuint target)
         ext[i] = std::tolower(ext[i]);
     }
 
-    auto it = loaders.find(ext);
-    if (it == loaders.end())
+    std::unique_lock<std::mutex> lock(codecs_mutex);
+    auto it = decoders.find(ext);
+    if (it == decoders.end())
     {
-        LOGE("load_from_file() called with unsupported extension ", ext);
+        lock.unlock();
+        LOGE("Cannot load image file with unsupported extension ", ext);
 
-        return false;
-    } else
+        return nullptr;
+    }
+
+    return it->second;
+}
+}
+
+struct decode_request_t
+{
+    decode_callback_t callback;
+};
+
+std::shared_ptr<const decoded_image_t> decode_file(std::string name)
+{
+    struct stat info;
+    auto decoder = find_decoder(name, info);
+    if (!decoder)
+    {
+        return nullptr;
+    }
+
+    if (auto cached = decoded_cache.lookup(name, info))
+    {
+        return cached;
+    }
+
+    mapped_file_t file{name};
+    if (!file.data)
     {
-        return it->second(name.c_str(), target);
+        LOGE("failed to read image file ", name);
+        return nullptr;
     }
+
+    auto image = std::make_shared<decoded_image_t>();
+    if (!decoder(file.data, file.size, *image))
+    {
+        LOGE("failed to decode image file ", name);
+        return nullptr;
+    }
+
+    decoded_cache.insert(name, file.info, image);
+    return image;
+}
+
+std::shared_ptr<decode_request_t> decode_file_async(std::string name, decode_callback_t callback)
+{
+    struct stat info;
+    if (!find_decoder(name, info))
+    {
+        callback(nullptr);
+        return nullptr;
+    }
+
+    if (auto cached = decoded_cache.lookup(name, info))
+    {
+        callback(cached);
+        return nullptr;
+    }
+
+    auto request = std::make_shared<decode_request_t>();
+    request->callback = std::move(callback);
+
+    // The request (and thus the callback, which usually comes from a plugin) is owned by the caller,
+    // so that it can be dropped together with the plugin while the image is still being decoded.
+    std::weak_ptr<decode_request_t> weak_request = request;
+    auto result = std::make_shared<std::shared_ptr<const decoded_image_t>>();
+    wf::get_core_impl().worker_pool->submit([name, result] ()
+    {
+        *result = decode_file(name);
+    }, [weak_request, result] ()
+    {
+        if (auto request = weak_request.lock())
+        {
+            auto callback = std::move(request->callback);
+            request.reset();
+            callback(*result);
+        }
+    });
+
+    return request;
+}
+
+static bool upload_to_texture(const decoded_image_t& image, GLuint target, const void *caller)
+{
+    bool result = true;
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+    if (target == GL_TEXTURE_CUBE_MAP)
+    {
+        result = load_data_as_cubemap(image.pixels.data(), image.width, image.height,
+            image.channels);
+    } else if (target == GL_TEXTURE_2D)
+    {
+        auto format = (image.channels == 4 ? GL_RGBA : GL_RGB);
+        GL_CALL(glTexImage2D(target, 0, format, image.width, image.height, 0,
+            format, GL_UNSIGNED_BYTE, image.pixels.data()));
+    }
+
+    GL_CALL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+    GLint tex = 0;
+    GL_CALL(glGetIntegerv(target == GL_TEXTURE_CUBE_MAP ?
+        GL_TEXTURE_BINDING_CUBE_MAP : GL_TEXTURE_BINDING_2D, &tex));
+    if (result && tex)
+    {
+        if (target == GL_TEXTURE_CUBE_MAP)
+        {
+            // Six square faces, cut out of the 4x3 grid of the image
+            const int face = image.width / 4;
+            wf::gpu_resources::track_texture(tex, face, 6 * face, caller);
+        } else
+        {
+            wf::gpu_resources::track_texture(tex, image.width, image.height, caller);
+        }
+    }
+
+    return result;
+}
+
+bool upload_to_texture(const decoded_image_t& image, GLuint target)
+{
+    return upload_to_texture(image, target, __builtin_return_address(0));
+}
+
+bool load_from_file(std::string name, GLuint target)
+{
+    auto image = decode_file(name);
+    return image && upload_to_texture(*image, target, __builtin_return_address(0));
+}
+
+void register_writer(std::string type, writer_t writer)
+{
+    std::lock_guard<std::mutex> lock(codecs_mutex);
+    writers[type] = writer;
 }
 
 void write_to_file(std::string name, uint8_t *pixels, int w, int h, std::string type,
     bool invert)
 {
-    auto it = writers.find(type);
+    auto writer = find_writer(type);
 
-    if (it == writers.end())
+    if (!writer)
     {
         LOGE("unsupported image_writer backend");
     } else
     {
-        it->second(name.c_str(), pixels, w, h, invert);
+        writer(name.c_str(), pixels, w, h, invert);
     }
 }
 
@@ -420,13 +894,195 @@ void write_to_file(std::string name, wf::framebuffer_t fb)
         fb.viewport_width, fb.viewport_height, "png", false);
 }
 
+struct write_request_t
+{
+    std::function<void (bool)> callback;
+};
+
+namespace
+{
+/** A framebuffer readback which the GPU may not have finished yet. */
+struct pending_readback_t
+{
+    GLuint pbo;
+    GLsync fence;
+    int width;
+    int height;
+    std::string name;
+    Writer writer;
+    std::weak_ptr<write_request_t> request;
+};
+
+/**
+ * Readbacks are queued into pixel buffer objects, followed by a fence. We poll the fences from the
+ * event loop until the copy is done, then map the buffer and hand the pixels to a worker thread.
+ */
+struct readback_queue_t
+{
+    std::vector<pending_readback_t> pending;
+    wf::wl_timer<true> poll_timer;
+
+    static constexpr int POLL_INTERVAL_MS = 2;
+
+    void add(pending_readback_t readback)
+    {
+        pending.push_back(std::move(readback));
+        if (!poll_timer.is_connected())
+        {
+            poll_timer.set_timeout(POLL_INTERVAL_MS, [=] ()
+            {
+                poll();
+                return !pending.empty();
+            });
+        }
+    }
+
+    void poll()
+    {
+        OpenGL::render_begin();
+        auto it = pending.begin();
+        while (it != pending.end())
+        {
+            GLenum status = GL_CALL(glClientWaitSync(it->fence, 0, 0));
+            if (status == GL_TIMEOUT_EXPIRED)
+            {
+                ++it;
+                continue;
+            }
+
+            auto pixels = std::make_shared<std::vector<uint8_t>>();
+            if (status != GL_WAIT_FAILED)
+            {
+                size_t size = it->width * it->height * 4;
+                GL_CALL(glBindBuffer(GL_PIXEL_PACK_BUFFER, it->pbo));
+                void *mapped = GL_CALL(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT));
+                if (mapped)
+                {
+                    pixels->assign((uint8_t*)mapped, (uint8_t*)mapped + size);
+                    GL_CALL(glUnmapBuffer(GL_PIXEL_PACK_BUFFER));
+                }
+
+                GL_CALL(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+            }
+
+            release(*it);
+            encode(*it, pixels);
+            it = pending.erase(it);
+        }
+
+        OpenGL::render_end();
+    }
+
+    void encode(const pending_readback_t& readback, std::shared_ptr<std::vector<uint8_t>> pixels)
+    {
+        auto result = std::make_shared<bool>(false);
+        auto job    = [=, writer = readback.writer, name = readback.name,
+                       width = readback.width, height = readback.height] ()
+        {
+            *result = !pixels->empty() && writer(name.c_str(), pixels->data(), width, height, false);
+        };
+
+        wf::get_core_impl().worker_pool->submit(job,
+            [result, name = readback.name, weak_request = readback.request] ()
+        {
+            if (!*result)
+            {
+                LOGE("Failed to write image file ", name);
+            }
+
+            if (auto request = weak_request.lock())
+            {
+                auto callback = std::move(request->callback);
+                request.reset();
+                if (callback)
+                {
+                    callback(*result);
+                }
+            }
+        });
+    }
+
+    void release(pending_readback_t& readback)
+    {
+        GL_CALL(glDeleteSync(readback.fence));
+        GL_CALL(glDeleteBuffers(1, &readback.pbo));
+    }
+
+    ~readback_queue_t()
+    {
+        if (!pending.empty())
+        {
+            OpenGL::render_begin();
+            for (auto& readback : pending)
+            {
+                release(readback);
+            }
+
+            OpenGL::render_end();
+        }
+    }
+};
+
+std::unique_ptr<readback_queue_t> readback_queue;
+}
+
+std::shared_ptr<write_request_t> write_to_file_async(std::string name, wf::framebuffer_t fb,
+    std::string type, std::function<void (bool)> callback)
+{
+    auto writer = find_writer(type);
+    if (!writer || !readback_queue)
+    {
+        LOGE("unsupported image_writer backend");
+        if (callback)
+        {
+            callback(false);
+        }
+
+        return nullptr;
+    }
+
+    auto request = std::make_shared<write_request_t>();
+    request->callback = std::move(callback);
+
+    pending_readback_t readback;
+    readback.width   = fb.viewport_width;
+    readback.height  = fb.viewport_height;
+    readback.name    = name;
+    readback.writer  = std::move(writer);
+    readback.request = request;
+
+    OpenGL::render_begin();
+    GL_CALL(glGenBuffers(1, &readback.pbo));
+    GL_CALL(glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo));
+    GL_CALL(glBufferData(GL_PIXEL_PACK_BUFFER, readback.width * readback.height * 4, NULL,
+        GL_STREAM_READ));
+    GL_CALL(glBindFramebuffer(GL_READ_FRAMEBUFFER, fb.fb));
+    GL_CALL(glReadPixels(0, 0, readback.width, readback.height, GL_RGBA, GL_UNSIGNED_BYTE, 0));
+    GL_CALL(glBindBuffer(GL_PIXEL_PACK_BUFFER, 0));
+    readback.fence = GL_CALL(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+    GL_CALL(glFlush());
+    OpenGL::render_end();
+
+    readback_queue->add(std::move(readback));
+    return request;
+}
+
 void init()
 {
     LOGD("init ImageIO");
+    std::lock_guard<std::mutex> lock(codecs_mutex);
 #ifdef BUILD_WITH_IMAGEIO
-    loaders["png"] = Loader(texture_from_png);
-    loaders["jpg"] = Loader(texture_from_jpeg);
+    decoders["png"] = Decoder(decode_png);
+    decoders["jpg"] = Decoder(decode_jpeg);
     writers["png"] = Writer(texture_to_png);
 #endif
+    decoders["qoi"] = Decoder(decode_qoi);
+    writers["qoi"] = Writer(texture_to_qoi);
+    readback_queue = std::make_unique<readback_queue_t>();
+}
+
+void fini()
+{
+    readback_queue.reset();
 }
 }
@@ -5,6 +5,46 @@
 #include <wayfire/condition/condition.hpp>
 #include <wayfire/view-access-interface.hpp>
 #include <wayfire/parser/condition_parser.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/toplevel-view.hpp>
+
+#include <set>
+#include <unordered_map>
+
+namespace
+{
+/**
+ * Properties whose changes are reflected in view_interface_t::get_properties_version(). Match results which
+ * only depend on these can be cached until the version changes.
+ *
+ * Tiling and fullscreen state are not included: the access interface reads the pending state, which
+ * changes some time before the signals are emitted when the transaction is applied. The role is not
+ * included either, because view_interface_t::set_role() does not change the version.
+ */
+const std::set<std::string> tracked_properties = {
+    "app_id", "title", "minimized", "activated", "mapped",
+};
+
+/**
+ * Forwards lookups to the view access interface and remembers whether any of them was for a property
+ * which is not tracked.
+ */
+class recording_access_interface_t : public wf::access_interface_t
+{
+  public:
+    wf::view_access_interface_t source;
+    bool only_tracked = true;
+
+    recording_access_interface_t(wayfire_view view) : source(view)
+    {}
+
+    wf::variant_t get(const std::string & identifier, bool & error) override
+    {
+        only_tracked &= (tracked_properties.count(identifier) > 0);
+        return source.get(identifier, error);
+    }
+};
+}
 
 class wf::view_matcher_t::impl
 {
@@ -15,8 +55,31 @@ class wf::view_matcher_t::impl
     wf::condition_parser_t parser;
     std::shared_ptr<wf::condition_t> condition;
 
+    struct cached_result_t
+    {
+        uint64_t view_version;
+        bool result;
+    };
+
+    /** Cached results by view id, see matches(). */
+    std::unordered_map<uint32_t, cached_result_t> cache;
+
+    /** Connected to each view in the cache, to drop its entry when it is destroyed. */
+    wf::signal::connection_t<wf::destruct_signal<wf::view_interface_t>> on_view_destruct =
+        [=] (wf::destruct_signal<wf::view_interface_t> *ev)
+    {
+        cache.erase(ev->object->get_id());
+    };
+
+    void clear_cache()
+    {
+        cache.clear();
+        on_view_destruct.disconnect();
+    }
+
     bool try_parse(const std::string& value, const std::string& opt_name)
     {
+        clear_cache();
         lexer.reset(value);
         try {
             condition = parser.parse(lexer);
@@ -110,15 +173,45 @@ void wf::view_matcher_t::set_from_option(
 
 bool wf::view_matcher_t::matches(wayfire_view view)
 {
-    if (this->priv->condition)
+    if (!this->priv->condition)
+    {
+        return false;
+    }
+
+    if (!view)
     {
         bool ignored = false;
         wf::view_access_interface_t access_interface{view};
-
         return this->priv->condition->evaluate(access_interface, ignored);
     }
 
-    return false;
+    auto& cache  = this->priv->cache;
+    auto version = view->get_properties_version();
+    auto it = cache.find(view->get_id());
+    if ((it != cache.end()) && (it->second.view_version == version))
+    {
+        return it->second.result;
+    }
+
+    bool ignored = false;
+    recording_access_interface_t access_interface{view};
+    bool result = this->priv->condition->evaluate(access_interface, ignored);
+
+    if (access_interface.only_tracked)
+    {
+        if (it == cache.end())
+        {
+            view->connect(&priv->on_view_destruct);
+        }
+
+        cache[view->get_id()] = {version, result};
+    } else if (it != cache.end())
+    {
+        cache.erase(it);
+        view->disconnect(&priv->on_view_destruct);
+    }
+
+    return result;
 }
 
 wf::view_matcher_t::~view_matcher_t() = default;
@@ -1,6 +1,8 @@
 #include <wayfire/util/log.hpp>
 #include <map>
 #include "opengl-priv.hpp"
+#include "wayfire/framebuffer-pool.hpp"
+#include "wayfire/gpu-resources.hpp"
 #include "wayfire/geometry.hpp"
 #include "wayfire/output.hpp"
 #include "core-impl.hpp"
@@ -125,6 +127,7 @@ void init()
 void fini()
 {
     render_begin();
+    wf::get_framebuffer_pool().clear();
     program.free_resources();
     color_program.free_resources();
     render_end();
@@ -344,11 +347,13 @@ static std::string framebuffer_status_to_str(
 
 bool wf::framebuffer_t::allocate(int width, int height)
 {
+    const void *caller  = __builtin_return_address(0);
     bool first_allocate = false;
     if (fb == (uint32_t)-1)
     {
         first_allocate = true;
         GL_CALL(glGenFramebuffers(1, &fb));
+        wf::gpu_resources::track_framebuffer(fb, caller);
     }
 
     if (tex == (uint32_t)-1)
@@ -374,6 +379,7 @@ bool wf::framebuffer_t::allocate(int width, int height)
             GL_CALL(glBindTexture(GL_TEXTURE_2D, tex));
             GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height,
                 0, GL_RGBA, GL_UNSIGNED_BYTE, 0));
+            wf::gpu_resources::track_texture(tex, width, height, caller);
         }
     }
 
@@ -420,11 +426,13 @@ void wf::framebuffer_t::release()
 {
     if ((fb != uint32_t(-1)) && (fb != 0))
     {
+        wf::gpu_resources::untrack_framebuffer(fb);
         GL_CALL(glDeleteFramebuffers(1, &fb));
     }
 
     if ((tex != uint32_t(-1)) && ((fb != 0) || (tex != 0)))
     {
+        wf::gpu_resources::untrack_texture(tex);
         GL_CALL(glDeleteTextures(1, &tex));
     }
 
@@ -951,7 +951,10 @@ class output_layout_t::impl
 
     wf::signal::connection_t<wf::reload_config_signal> on_config_reload = [=] (wf::reload_config_signal *ev)
     {
-        reconfigure_from_config();
+        if (ev->may_have_changed("output") || ev->may_have_changed("workarounds"))
+        {
+            reconfigure_from_config();
+        }
     };
 
     wf::signal::connection_t<core_backend_started_signal> on_backend_started =
@@ -2,20 +2,63 @@
 #include <algorithm>
 #include <memory>
 #include <filesystem>
+#include <chrono>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "plugin-loader.hpp"
 #include "../core/wm.hpp"
 #include "wayfire/plugin.hpp"
+#include "wayfire/core.hpp"
+#include "wayfire/output.hpp"
+#include "wayfire/output-layout.hpp"
+#include "wayfire/debug.hpp"
+#include "wayfire/trace.hpp"
 #include <wayfire/util/log.hpp>
 
+using plugin_clock = std::chrono::steady_clock;
+
+static double elapsed_ms(plugin_clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(plugin_clock::now() - since).count();
+}
+
+/**
+ * Ask the kernel to start reading the given files in the background.
+ *
+ * dlopen() itself has to run serially (the dynamic linker holds a global lock while running the static
+ * initializers of the library), but the I/O for all plugins can happen in parallel with it. On slow
+ * storage, this hides most of the time spent waiting for the disk.
+ */
+static void prefetch_plugin_files(const std::vector<std::string>& paths)
+{
+    for (auto& path : paths)
+    {
+        int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+}
+
 wf::plugin_manager_t::plugin_manager_t()
 {
     this->plugins_opt.load_option("core/plugins");
     this->enable_so_unloading.load_option("workarounds/enable_so_unloading");
+    this->lazy_plugin_init.load_option("core/lazy_plugin_init");
 
     reload_dynamic_plugins();
     load_static_plugins();
+    is_startup = false;
+    if (!deferred_plugins.empty())
+    {
+        schedule_deferred_init();
+    }
 
     this->plugins_opt.set_callback([=] ()
     {
@@ -52,7 +95,11 @@ wf::plugin_manager_t::~plugin_manager_t()
 void wf::plugin_manager_t::destroy_plugin(wf::loaded_plugin_t& p)
 {
     LOGD("Unloading plugin ", p.so_path);
-    p.instance->fini();
+    if (p.initialized)
+    {
+        p.instance->fini();
+    }
+
     p.instance.reset();
 
     /* dlopen()/dlclose() do reference counting, so we should close the plugin
@@ -203,30 +250,125 @@ void wf::plugin_manager_t::reload_dynamic_plugins()
     /* load new plugins */
     std::vector<std::pair<std::string, wf::loaded_plugin_t>> pending_initialize;
 
-    for (auto plugin : next_plugins)
+    std::vector<std::string> new_plugins;
+    for (auto& plugin : next_plugins)
     {
-        if (loaded_plugins.count(plugin))
+        if (!loaded_plugins.count(plugin))
         {
-            continue;
+            new_plugins.push_back(plugin);
         }
+    }
 
+    auto load_start = plugin_clock::now();
+    prefetch_plugin_files(new_plugins);
+    for (auto& plugin : new_plugins)
+    {
+        WF_TRACE_SCOPE(plugin);
+        auto start = plugin_clock::now();
         std::optional<wf::loaded_plugin_t> ptr = load_plugin_from_file(plugin);
         if (ptr)
         {
+            LOGC(PLUGINS, "Loaded ", plugin, " in ", elapsed_ms(start), "ms");
             pending_initialize.emplace_back(plugin, std::move(*ptr));
         }
     }
 
+    double load_time = elapsed_ms(load_start);
+
     std::stable_sort(pending_initialize.begin(), pending_initialize.end(), [] (const auto& a, const auto& b)
     {
         return a.second.instance->get_order_hint() < b.second.instance->get_order_hint();
     });
 
+    auto init_start = plugin_clock::now();
     for (auto& [plugin, ptr] : pending_initialize)
     {
-        ptr.instance->init();
-        loaded_plugins[plugin] = std::move(ptr);
+        auto& loaded = loaded_plugins[plugin] = std::move(ptr);
+        if (is_startup && lazy_plugin_init && loaded.instance->can_defer_init())
+        {
+            LOGC(PLUGINS, "Deferring initialization of ", plugin);
+            deferred_plugins.push_back(plugin);
+            continue;
+        }
+
+        init_plugin(plugin, loaded);
+    }
+
+    WF_TRACE_COUNTER("loaded plugins", (int64_t)loaded_plugins.size());
+    if (!pending_initialize.empty())
+    {
+        LOGC(PLUGINS, "Loaded ", pending_initialize.size(), " plugins in ", load_time, "ms, initialized in ",
+            elapsed_ms(init_start), "ms");
+    }
+}
+
+void wf::plugin_manager_t::init_plugin(const std::string& name, loaded_plugin_t& plugin)
+{
+    WF_TRACE_SCOPE(name);
+    auto start = plugin_clock::now();
+    plugin.instance->init();
+    plugin.initialized = true;
+    LOGC(PLUGINS, "Initialized ", name, " in ", elapsed_ms(start), "ms");
+}
+
+void wf::plugin_manager_t::schedule_deferred_init()
+{
+    on_frame_done = [=] (wf::frame_done_signal*)
+    {
+        // Wait for the frame to actually reach the screen before doing more work.
+        idle_init_deferred.run_once([=] () { init_deferred_plugins(); });
+    };
+
+    on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        ev->output->connect(&on_frame_done);
+    };
+
+    for (auto& wo : wf::get_core().output_layout->get_outputs())
+    {
+        wo->connect(&on_frame_done);
     }
+
+    wf::get_core().output_layout->connect(&on_output_added);
+
+    // The input signals are emitted before bindings are handled, so the bindings of the deferred plugins
+    // are registered in time for the event.
+    on_key_before_init    = [=] (auto) { init_deferred_plugins(); };
+    on_button_before_init = [=] (auto) { init_deferred_plugins(); };
+    on_touch_before_init  = [=] (auto) { init_deferred_plugins(); };
+    wf::get_core().connect(&on_key_before_init);
+    wf::get_core().connect(&on_button_before_init);
+    wf::get_core().connect(&on_touch_before_init);
+
+    // In case no output shows a frame soon (for example all outputs are off), do not wait forever.
+    deferred_init_timeout.set_timeout(1000, [=] () { init_deferred_plugins(); });
+}
+
+void wf::plugin_manager_t::init_deferred_plugins()
+{
+    on_frame_done.disconnect();
+    on_output_added.disconnect();
+    on_key_before_init.disconnect();
+    on_button_before_init.disconnect();
+    on_touch_before_init.disconnect();
+    deferred_init_timeout.disconnect();
+    idle_init_deferred.disconnect();
+
+    WF_TRACE_SCOPE("deferred plugins");
+    auto start = plugin_clock::now();
+    auto plugins = std::move(deferred_plugins);
+    deferred_plugins.clear();
+    for (auto& name : plugins)
+    {
+        // The plugin may have been unloaded in the meantime.
+        auto it = loaded_plugins.find(name);
+        if ((it != loaded_plugins.end()) && !it->second.initialized)
+        {
+            init_plugin(name, it->second);
+        }
+    }
+
+    LOGC(PLUGINS, "Initialized ", plugins.size(), " deferred plugins in ", elapsed_ms(start), "ms");
 }
 
 template<class T>
@@ -237,6 +379,7 @@ static wf::loaded_plugin_t create_plugin(std::string name)
     lp.so_handle = nullptr;
     lp.so_path   = name;
     lp.instance->init();
+    lp.initialized = true;
     return lp;
 }
 
@@ -6,6 +6,9 @@
 #include "config.h"
 #include "wayfire/util.hpp"
 #include <wayfire/option-wrapper.hpp>
+#include <wayfire/render-manager.hpp>
+#include <wayfire/signal-definitions.hpp>
+#include <wayfire/nonstd/wlroots-full.hpp>
 
 namespace wf
 {
@@ -19,6 +22,9 @@ struct loaded_plugin_t
 
     // A path to the .so file of the plugin.
     std::string so_path;
+
+    // Whether init() has been called on the instance.
+    bool initialized = false;
 };
 
 struct plugin_manager_t
@@ -32,9 +38,34 @@ struct plugin_manager_t
   private:
     wf::option_wrapper_t<std::string> plugins_opt;
     wf::option_wrapper_t<bool> enable_so_unloading;
+    wf::option_wrapper_t<bool> lazy_plugin_init;
     std::unordered_map<std::string, loaded_plugin_t> loaded_plugins;
 
+    /** Whether the plugins are being loaded for the first time, i.e. on startup. */
+    bool is_startup = true;
+
+    /**
+     * Plugins whose initialization was deferred until after the first frame, in the order they should be
+     * initialized in.
+     *
+     * Core cannot know which bindings a plugin will register before initializing it, so the plugins are not
+     * initialized on their first use. Instead, all of them are initialized after the first frame, after 1s,
+     * or right before the first key, button or touch event is processed, whichever comes first. Bindings
+     * pressed early during startup therefore still work.
+     */
+    std::vector<std::string> deferred_plugins;
+    wf::wl_idle_call idle_init_deferred;
+    wf::wl_timer<false> deferred_init_timeout;
+    wf::signal::connection_t<wf::frame_done_signal> on_frame_done;
+    wf::signal::connection_t<wf::output_added_signal> on_output_added;
+    wf::signal::connection_t<wf::input_event_signal<wlr_keyboard_key_event>> on_key_before_init;
+    wf::signal::connection_t<wf::input_event_signal<wlr_pointer_button_event>> on_button_before_init;
+    wf::signal::connection_t<wf::input_event_signal<wlr_touch_down_event>> on_touch_before_init;
+
     void deinit_plugins(bool unloadable);
+    void init_plugin(const std::string& name, loaded_plugin_t& plugin);
+    void schedule_deferred_init();
+    void init_deferred_plugins();
 
     std::optional<loaded_plugin_t> load_plugin_from_file(std::string path);
     void load_static_plugins();
@@ -3,7 +3,10 @@
 #include "wayfire/bindings-repository.hpp"
 #include "hotspot-manager.hpp"
 #include "wayfire/signal-definitions.hpp"
+#include <wayfire/core.hpp>
 #include <wayfire/debug.hpp>
+#include <algorithm>
+#include <set>
 
 struct wf::bindings_repository_t::impl
 {
@@ -26,7 +29,12 @@ struct wf::bindings_repository_t::impl
         });
     }
 
-    void reparse_extensions();
+    /**
+     * Re-parse the extensions of the activator bindings on the next idle.
+     *
+     * @param options If set, only bindings for these options are re-parsed, otherwise all of them.
+     */
+    void reparse_extensions(const std::set<const wf::config::option_base_t*> *options = nullptr);
 
     binding_container_t<wf::keybinding_t, key_callback> keys;
     binding_container_t<wf::keybinding_t, axis_callback> axes;
@@ -37,12 +45,45 @@ struct wf::bindings_repository_t::impl
 
     wf::signal::connection_t<wf::reload_config_signal> on_config_reload = [=] (wf::reload_config_signal *ev)
     {
-        recreate_hotspots();
-        reparse_extensions();
+        if (ev->changed_sections.empty())
+        {
+            recreate_hotspots();
+            reparse_extensions();
+            return;
+        }
+
+        // Bindings created by plugins from other options (for example from dynamic lists) are not part of
+        // any section. The plugins add them again when their options change, which re-parses them.
+        std::set<const wf::config::option_base_t*> changed;
+        for (auto& name : ev->changed_sections)
+        {
+            if (auto section = wf::get_core().config.get_section(name))
+            {
+                for (auto& opt : section->get_registered_options())
+                {
+                    changed.insert(opt.get());
+                }
+            }
+        }
+
+        bool activators_changed = std::any_of(activators.begin(), activators.end(), [&] (auto& binding)
+        {
+            return changed.count(binding->activated_by.get());
+        });
+
+        if (activators_changed)
+        {
+            recreate_hotspots();
+            reparse_extensions(&changed);
+        }
     };
 
     wf::wl_idle_call idle_recreate_hotspots;
     wf::wl_idle_call idle_reparse_bindings;
 
+    /** The options whose bindings are waiting to be re-parsed, unless all of them are. */
+    std::set<const wf::config::option_base_t*> pending_reparse;
+    bool pending_reparse_all = false;
+
     int enabled = 1;
 };
@@ -40,6 +40,8 @@ void wf::bindings_repository_t::add_activator(
     option_sptr_t<activatorbinding_t> activator, wf::activator_callback *cb)
 {
     push_binding(priv->activators, activator, cb);
+    std::set<const wf::config::option_base_t*> options = {activator.get()};
+    priv->reparse_extensions(&options);
     if (activator->get_value().get_hotspots().size())
     {
         priv->recreate_hotspots();
@@ -275,17 +277,39 @@ void wf::bindings_repository_t::set_enabled(bool enabled)
     priv->recreate_hotspots();
 }
 
-void wf::bindings_repository_t::impl::reparse_extensions()
+void wf::bindings_repository_t::impl::reparse_extensions(
+    const std::set<const wf::config::option_base_t*> *options)
 {
+    if (options)
+    {
+        pending_reparse.insert(options->begin(), options->end());
+    } else
+    {
+        pending_reparse_all = true;
+    }
+
     for (auto& binding : this->activators)
     {
-        binding->tags.clear();
+        if (!options || options->count(binding->activated_by.get()))
+        {
+            binding->tags.clear();
+        }
     }
 
     idle_reparse_bindings.run_once([=]
     {
+        auto reparse = std::move(pending_reparse);
+        bool reparse_all = pending_reparse_all;
+        pending_reparse.clear();
+        pending_reparse_all = false;
+
         for (auto& binding : this->activators)
         {
+            if (!reparse_all && !reparse.count(binding->activated_by.get()))
+            {
+                continue;
+            }
+
             auto value = binding->activated_by->get_value();
             for (auto& ext : value.get_extensions())
             {
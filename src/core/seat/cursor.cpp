@@ -20,9 +20,12 @@ wf::cursor_t::cursor_t(wf::seat_t *seat)
     wlr_cursor_warp(cursor, NULL, cursor->x, cursor->y);
     init_xcursor();
 
-    config_reloaded = [=] (auto)
+    config_reloaded = [=] (wf::reload_config_signal *ev)
     {
-        init_xcursor();
+        if (ev->may_have_changed("input"))
+        {
+            init_xcursor();
+        }
     };
 
     wf::get_core().connect(&config_reloaded);
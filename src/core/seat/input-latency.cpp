@@ -0,0 +1,188 @@
+#include "input-latency.hpp"
+#include "input-manager.hpp"
+#include "../core-impl.hpp"
+#include "wayfire/output.hpp"
+#include "wayfire/output-layout.hpp"
+#include "wayfire/seat.hpp"
+#include <wayfire/input-device.hpp>
+
+#include <time.h>
+
+/**
+ * The maximal number of frames in flight on an output. If an output has more, some present events were
+ * missed and the oldest frames are dropped.
+ */
+static constexpr size_t MAX_FRAMES_IN_FLIGHT = 4;
+
+/**
+ * Pending events older than this many refresh periods when an output commits did not trigger the frame, and
+ * are dropped instead of being attached to it.
+ */
+static constexpr int64_t MAX_PENDING_REFRESH_PERIODS = 2;
+
+/** The refresh rate assumed for outputs which do not report one, in mHz. */
+static constexpr int64_t DEFAULT_REFRESH_MHZ = 60'000;
+
+static int64_t timespec_to_us(const timespec& ts)
+{
+    return ts.tv_sec * 1'000'000ll + ts.tv_nsec / 1000;
+}
+
+wf::input_latency_tracker_t::input_latency_tracker_t()
+{
+    on_output_added = [=] (wf::output_added_signal *ev)
+    {
+        track_output(ev->output);
+    };
+
+    on_output_removed = [=] (wf::output_pre_remove_signal *ev)
+    {
+        outputs.erase(ev->output);
+    };
+
+    for (auto& wo : wf::get_core().output_layout->get_outputs())
+    {
+        track_output(wo);
+    }
+
+    wf::get_core().output_layout->connect(&on_output_added);
+    wf::get_core().output_layout->connect(&on_output_removed);
+}
+
+void wf::input_latency_tracker_t::track_output(wf::output_t *output)
+{
+    auto state = std::make_unique<output_state_t>();
+    auto raw   = state.get();
+    state->output = output;
+
+    state->on_commit.set_callback([=] (void *data)
+    {
+        auto ev = static_cast<wlr_output_event_commit*>(data);
+        if (!(ev->committed & WLR_OUTPUT_STATE_BUFFER))
+        {
+            return;
+        }
+
+        handle_frame_committed(*raw);
+    });
+
+    state->on_present.set_callback([=] (void *data)
+    {
+        handle_frame_presented(*raw, static_cast<wlr_output_event_present*>(data));
+    });
+
+    state->on_commit.connect(&output->handle->events.commit);
+    state->on_present.connect(&output->handle->events.present);
+    outputs[output] = std::move(state);
+}
+
+void wf::input_latency_tracker_t::handle_input_event(wlr_input_device *device)
+{
+    auto output = get_target_output(device);
+    if (!output || !outputs.count(output))
+    {
+        return;
+    }
+
+    auto& pending = outputs[output]->pending;
+    if (!pending.count(device))
+    {
+        pending[device] = get_time_us();
+    }
+}
+
+wf::output_t*wf::input_latency_tracker_t::get_target_output(wlr_input_device *device)
+{
+    switch (device->type)
+    {
+      case WLR_INPUT_DEVICE_POINTER:
+      case WLR_INPUT_DEVICE_TABLET_TOOL:
+      case WLR_INPUT_DEVICE_TOUCH:
+      {
+        auto cursor = wf::get_core().get_cursor_position();
+        return wf::get_core().output_layout->get_output_at(cursor.x, cursor.y);
+      }
+
+      default:
+        return wf::get_core().seat->get_active_output();
+    }
+}
+
+void wf::input_latency_tracker_t::handle_frame_committed(output_state_t& state)
+{
+    const int64_t refresh_mhz = state.output->handle->refresh > 0 ?
+        state.output->handle->refresh : DEFAULT_REFRESH_MHZ;
+    const int64_t max_age_us = MAX_PENDING_REFRESH_PERIODS * 1'000'000'000ll / refresh_mhz;
+    const int64_t now = get_time_us();
+
+    input_events_t events = std::move(state.retry);
+    state.retry.clear();
+    for (auto& [device, time] : state.pending)
+    {
+        if ((now - time <= max_age_us) && !events.count(device))
+        {
+            events[device] = time;
+        }
+    }
+
+    state.pending.clear();
+    state.frames.push_back(std::move(events));
+    if (state.frames.size() > MAX_FRAMES_IN_FLIGHT)
+    {
+        state.frames.pop_front();
+    }
+}
+
+void wf::input_latency_tracker_t::handle_frame_presented(output_state_t& state,
+    wlr_output_event_present *ev)
+{
+    if (state.frames.empty())
+    {
+        return;
+    }
+
+    auto events = std::move(state.frames.front());
+    state.frames.pop_front();
+    if (!ev->presented)
+    {
+        // The events will become visible in a later frame instead.
+        for (auto& [device, time] : events)
+        {
+            auto it = state.retry.find(device);
+            if ((it == state.retry.end()) || (it->second > time))
+            {
+                state.retry[device] = time;
+            }
+        }
+
+        return;
+    }
+
+    if (events.empty())
+    {
+        return;
+    }
+
+    const int64_t presented_at = ev->when ? timespec_to_us(*ev->when) : get_time_us();
+    for (auto& device : wf::get_core().get_input_devices())
+    {
+        auto it = events.find(device->get_wlr_handle());
+        if (it != events.end())
+        {
+            device->get_latency_histogram().add(std::max<int64_t>(presented_at - it->second, 0));
+        }
+    }
+}
+
+int64_t wf::input_latency_tracker_t::get_time_us()
+{
+    // Use the same clock as the timestamps of present events.
+    timespec ts;
+    clock_gettime(wlr_backend_get_presentation_clock(wf::get_core().backend), &ts);
+    return timespec_to_us(ts);
+}
+
+void wf::track_input_latency(wlr_input_device *device)
+{
+    wf::get_core_impl().input->latency_tracker.handle_input_event(device);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+#include <wayfire/nonstd/wlroots-full.hpp>
+#include "wayfire/signal-definitions.hpp"
+#include "wayfire/util.hpp"
+
+namespace wf
+{
+/**
+ * The input latency tracker measures the time from input events reaching the compositor until the first
+ * frame after them is presented, and records it in the latency histograms of the input devices.
+ *
+ * Each event is assigned to the output it most likely affects: the output under the cursor for pointer-like
+ * devices, and the active output for keyboards and other devices. For each device and output, only the
+ * oldest event which is not part of a frame yet is tracked. When the output commits a new frame, the tracked
+ * events are attached to that frame, and once the frame is presented, their latencies are recorded. If the
+ * frame is discarded instead, the events are moved to the next frame.
+ *
+ * Events which did not cause any repaint would otherwise be attached to an unrelated frame much later, so
+ * events which are older than MAX_PENDING_REFRESH_PERIODS refresh periods when the output commits are
+ * dropped.
+ */
+class input_latency_tracker_t
+{
+  public:
+    input_latency_tracker_t();
+
+    /** An input event from the given device has just arrived. */
+    void handle_input_event(wlr_input_device *device);
+
+  private:
+    using input_events_t = std::map<wlr_input_device*, int64_t>;
+
+    struct output_state_t
+    {
+        wf::output_t *output;
+        wf::wl_listener_wrapper on_commit;
+        wf::wl_listener_wrapper on_present;
+
+        /** Input events which are not part of a frame yet. */
+        input_events_t pending;
+        /** Input events whose frame was discarded, these are not subject to the age limit. */
+        input_events_t retry;
+
+        /** The input events contained in each frame which has been committed but not presented yet. */
+        std::deque<input_events_t> frames;
+    };
+
+    std::map<wf::output_t*, std::unique_ptr<output_state_t>> outputs;
+
+    void track_output(wf::output_t *output);
+    void handle_frame_committed(output_state_t& state);
+    void handle_frame_presented(output_state_t& state, wlr_output_event_present *ev);
+    wf::output_t *get_target_output(wlr_input_device *device);
+    int64_t get_time_us();
+
+    wf::signal::connection_t<wf::output_added_signal> on_output_added;
+    wf::signal::connection_t<wf::output_pre_remove_signal> on_output_removed;
+};
+
+/**
+ * Record the arrival of an input event for latency tracking.
+ */
+void track_input_latency(wlr_input_device *device);
+}
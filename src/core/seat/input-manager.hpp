@@ -6,6 +6,8 @@
 #include <chrono>
 
 #include "seat-impl.hpp"
+#include "keymap-cache.hpp"
+#include "input-latency.hpp"
 #include "wayfire/plugin.hpp"
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/view.hpp"
@@ -37,6 +39,12 @@ class input_manager_t
      */
     uint32_t locked_mods = 0;
 
+    /** Compiled keymaps, shared by all keyboards. */
+    keymap_cache_t keymap_cache;
+
+    /** Measures the latency of input events, see input_device_t::get_latency_histogram(). */
+    input_latency_tracker_t latency_tracker;
+
     /**
      * Go through all input devices and map them to outputs as specified in the
      * config file or by hints in the wlroots backend.
@@ -69,6 +77,8 @@ class input_manager_t
 template<class EventType>
 wf::input_event_processing_mode_t emit_device_event_signal(EventType *event, wlr_input_device *device)
 {
+    wf::track_input_latency(device);
+
     wf::input_event_signal<EventType> data;
     data.event  = event;
     data.device = device;
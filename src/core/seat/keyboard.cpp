@@ -169,35 +169,27 @@ void wf::keyboard_t::reload_input_options()
 
     this->dirty_options = false;
 
-    auto ctx = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-
-    /* Copy memory to stack, so that .c_str() is valid */
-    std::string rules   = this->rules;
-    std::string model   = this->model;
-    std::string layout  = this->layout;
-    std::string variant = this->variant;
-    std::string options = this->options;
-
-    xkb_rule_names names;
-    names.rules   = rules.c_str();
-    names.model   = model.c_str();
-    names.layout  = layout.c_str();
-    names.variant = variant.c_str();
-    names.options = options.c_str();
-    auto keymap = xkb_map_new_from_names(ctx, &names,
-        XKB_KEYMAP_COMPILE_NO_FLAGS);
-
-    if (!keymap)
+    keymap_names_t names = {rules, model, layout, variant, options};
+    auto& cache = wf::get_core_impl().input->keymap_cache;
+    if (!handle->keymap)
     {
-        LOGE("Could not create keymap with given configuration:",
-            " rules=\"", rules, "\" model=\"", model, "\" layout=\"", layout,
-            "\" variant=\"", variant, "\" options=\"", options, "\"");
-
-        // reset to NULL
-        std::memset(&names, 0, sizeof(names));
-        keymap = xkb_map_new_from_names(ctx, &names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        // A new keyboard cannot be used without a keymap, so do not wait for it.
+        pending_keymap.reset();
+        set_keymap(cache.get(names));
+    } else
+    {
+        // Keep using the old keymap until the new one has been compiled.
+        pending_keymap = cache.get_async(names, [=] (xkb_keymap *keymap)
+        {
+            set_keymap(keymap);
+        });
     }
 
+    wlr_keyboard_set_repeat_info(handle, repeat_rate, repeat_delay);
+}
+
+void wf::keyboard_t::set_keymap(xkb_keymap *keymap)
+{
     xkb_mod_mask_t locked_mods = 0;
 
     if (wf::get_core_impl().input->locked_mods & KB_MOD_NUM_LOCK)
@@ -211,11 +203,6 @@ void wf::keyboard_t::reload_input_options()
     }
 
     wlr_keyboard_set_keymap(handle, keymap);
-    xkb_keymap_unref(keymap);
-    xkb_context_unref(ctx);
-
-    wlr_keyboard_set_repeat_info(handle, repeat_rate, repeat_delay);
-
     wlr_keyboard_notify_modifiers(handle, 0, 0, locked_mods, 0);
 }
 
@@ -2,6 +2,7 @@
 
 #include <chrono>
 #include "seat-impl.hpp"
+#include "keymap-cache.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/signal-provider.hpp"
 #include "wayfire/util.hpp"
@@ -42,6 +43,10 @@ class keyboard_t
 
     wf::signal::connection_t<wf::reload_config_signal> on_config_reload;
     void reload_input_options();
+    void set_keymap(xkb_keymap *keymap);
+
+    /** The keymap which is being compiled for the keyboard, if any. */
+    std::shared_ptr<keymap_request_t> pending_keymap;
 
     wf::option_wrapper_t<std::string> model, variant, layout, options, rules;
     wf::option_wrapper_t<int> repeat_rate, repeat_delay;
@@ -0,0 +1,182 @@
+#include "keymap-cache.hpp"
+#include "../core-impl.hpp"
+#include "../worker-pool.hpp"
+#include <wayfire/util/log.hpp>
+
+#include <cstring>
+
+/** The maximal number of keymaps to keep. Usually, all keyboards use the same one. */
+static constexpr size_t MAX_CACHED_KEYMAPS = 8;
+
+/**
+ * Compile the keymap for the given names. Falls back to the default keymap if the names are invalid.
+ * This function may be called from any thread, as long as the context is not used concurrently.
+ */
+static xkb_keymap *compile_keymap(xkb_context *ctx, const wf::keymap_names_t& names, bool& failed)
+{
+    xkb_rule_names rule_names;
+    rule_names.rules   = names[0].c_str();
+    rule_names.model   = names[1].c_str();
+    rule_names.layout  = names[2].c_str();
+    rule_names.variant = names[3].c_str();
+    rule_names.options = names[4].c_str();
+    auto keymap = xkb_map_new_from_names(ctx, &rule_names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+
+    failed = !keymap;
+    if (!keymap)
+    {
+        // reset to NULL
+        std::memset(&rule_names, 0, sizeof(rule_names));
+        keymap = xkb_map_new_from_names(ctx, &rule_names, XKB_KEYMAP_COMPILE_NO_FLAGS);
+    }
+
+    return keymap;
+}
+
+static void report_invalid_keymap(const wf::keymap_names_t& names)
+{
+    LOGE("Could not create keymap with given configuration:",
+        " rules=\"", names[0], "\" model=\"", names[1], "\" layout=\"", names[2],
+        "\" variant=\"", names[3], "\" options=\"", names[4], "\"");
+}
+
+wf::keymap_cache_t::keymap_cache_t()
+{
+    context = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+}
+
+wf::keymap_cache_t::~keymap_cache_t()
+{
+    for (auto& entry : entries)
+    {
+        xkb_keymap_unref(entry.keymap);
+    }
+
+    xkb_context_unref(context);
+}
+
+xkb_keymap*wf::keymap_cache_t::find(const keymap_names_t& names)
+{
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+    {
+        if (it->names == names)
+        {
+            entries.splice(entries.begin(), entries, it);
+            return entries.front().keymap;
+        }
+    }
+
+    return nullptr;
+}
+
+void wf::keymap_cache_t::insert(const keymap_names_t& names, xkb_keymap *keymap)
+{
+    if (find(names))
+    {
+        xkb_keymap_unref(keymap);
+        return;
+    }
+
+    entries.push_front({names, keymap});
+    if (entries.size() > MAX_CACHED_KEYMAPS)
+    {
+        // Keyboards using the keymap hold their own reference.
+        xkb_keymap_unref(entries.back().keymap);
+        entries.pop_back();
+    }
+}
+
+xkb_keymap*wf::keymap_cache_t::get(const keymap_names_t& names)
+{
+    if (auto keymap = find(names))
+    {
+        return keymap;
+    }
+
+    bool failed;
+    auto keymap = compile_keymap(context, names, failed);
+    if (failed)
+    {
+        report_invalid_keymap(names);
+    }
+
+    insert(names, keymap);
+    return keymap;
+}
+
+std::shared_ptr<wf::keymap_request_t> wf::keymap_cache_t::get_async(const keymap_names_t& names,
+    std::function<void(xkb_keymap*)> callback)
+{
+    if (auto keymap = find(names))
+    {
+        callback(keymap);
+        return nullptr;
+    }
+
+    auto request = std::make_shared<keymap_request_t>();
+    request->callback = std::move(callback);
+
+    auto& waiters = waiting[names];
+    waiters.push_back(request);
+    if (waiters.size() > 1)
+    {
+        // The keymap is already being compiled.
+        return request;
+    }
+
+    struct compile_result_t
+    {
+        xkb_keymap *keymap = nullptr;
+        bool failed = false;
+
+        ~compile_result_t()
+        {
+            if (keymap)
+            {
+                xkb_keymap_unref(keymap);
+            }
+        }
+    };
+
+    auto result = std::make_shared<compile_result_t>();
+    wf::get_core_impl().worker_pool->submit([names, result] ()
+    {
+        // xkb contexts are not thread-safe, so use a separate one. The keymap keeps it alive.
+        auto ctx = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+        if (ctx)
+        {
+            result->keymap = compile_keymap(ctx, names, result->failed);
+            xkb_context_unref(ctx);
+        }
+    }, [=] ()
+    {
+        if (result->failed)
+        {
+            report_invalid_keymap(names);
+        }
+
+        xkb_keymap *keymap;
+        if (result->keymap)
+        {
+            insert(names, result->keymap);
+            result->keymap = nullptr;
+            keymap = find(names);
+        } else
+        {
+            keymap = get(names);
+        }
+
+        auto waiters = std::move(waiting[names]);
+        waiting.erase(names);
+        for (auto& waiter : waiters)
+        {
+            if (auto request = waiter.lock())
+            {
+                auto cb = std::move(request->callback);
+                cb(keymap);
+            }
+        }
+    });
+
+    return request;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <xkbcommon/xkbcommon.h>
+
+namespace wf
+{
+/** The XKB rule names (rules, model, layout, variant, options) of a keymap. */
+using keymap_names_t = std::array<std::string, 5>;
+
+/**
+ * A pending request for a keymap which is being compiled in the background.
+ * The callback is not called if the request is destroyed before the keymap is ready.
+ */
+struct keymap_request_t
+{
+    std::function<void(xkb_keymap*)> callback;
+};
+
+/**
+ * The keymap cache keeps compiled keymaps, so that keyboards with the same configuration share a single
+ * keymap instead of compiling it again and again. This matters when many keyboards appear at once, for
+ * example after a KVM switch, and when the configuration is reloaded.
+ */
+class keymap_cache_t
+{
+  public:
+    keymap_cache_t();
+    ~keymap_cache_t();
+
+    keymap_cache_t(const keymap_cache_t&) = delete;
+    keymap_cache_t(keymap_cache_t&&) = delete;
+    keymap_cache_t& operator =(const keymap_cache_t&) = delete;
+    keymap_cache_t& operator =(keymap_cache_t&&) = delete;
+
+    /**
+     * Get the keymap for the given names, compiling it on the calling thread if necessary.
+     *
+     * If the keymap cannot be compiled, the default keymap is returned instead.
+     * The keymap is owned by the cache, users which keep it need to take a reference.
+     */
+    xkb_keymap *get(const keymap_names_t& names);
+
+    /**
+     * Get the keymap for the given names. If it is not cached yet, compile it on a worker thread.
+     *
+     * @param callback Called with the keymap when it is ready, on the main thread. The keymap is owned by
+     *   the cache, see get().
+     *
+     * @return nullptr if the keymap was cached and the callback has already been called. Otherwise, a
+     *   request object which must be kept alive until the keymap is ready.
+     */
+    std::shared_ptr<keymap_request_t> get_async(const keymap_names_t& names,
+        std::function<void(xkb_keymap*)> callback);
+
+  private:
+    /** Context for compiling keymaps on the main thread. */
+    xkb_context *context;
+
+    struct entry_t
+    {
+        keymap_names_t names;
+        xkb_keymap *keymap;
+    };
+
+    /** Cached keymaps, the most recently used first. */
+    std::list<entry_t> entries;
+
+    /** Requests waiting for a keymap which is being compiled. */
+    std::map<keymap_names_t, std::vector<std::weak_ptr<keymap_request_t>>> waiting;
+
+    xkb_keymap *find(const keymap_names_t& names);
+    void insert(const keymap_names_t& names, xkb_keymap *keymap);
+};
+}
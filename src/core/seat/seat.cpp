@@ -578,6 +578,11 @@ bool input_device_t::is_enabled()
     return mode == LIBINPUT_CONFIG_SEND_EVENTS_ENABLED;
 }
 
+input_latency_histogram_t& input_device_t::get_latency_histogram()
+{
+    return latency_histogram;
+}
+
 input_device_t::input_device_t(wlr_input_device *handle)
 {
     this->handle = handle;
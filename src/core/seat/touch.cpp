@@ -97,6 +97,7 @@ wf::touch_interface_t::touch_interface_t(wlr_cursor *cursor, wlr_seat *seat,
 
     on_frame.set_callback([&] (void*)
     {
+        flush_gesture_motion();
         wlr_seat_touch_notify_frame(wf::get_core().get_current_seat());
         wf::get_core().seat->notify_activity();
     });
@@ -153,6 +154,8 @@ void wf::touch_interface_t::rem_touch_gesture(
 {
     gestures.erase(std::remove(gestures.begin(), gestures.end(), gesture),
         gestures.end());
+    active_gestures.erase(std::remove(active_gestures.begin(), active_gestures.end(), gesture),
+        active_gestures.end());
 }
 
 void wf::touch_interface_t::set_touch_focus(wf::scene::node_ptr node,
@@ -199,16 +202,56 @@ void wf::touch_interface_t::transfer_grab(scene::node_ptr grab_node)
 
 void wf::touch_interface_t::update_gestures(const wf::touch::gesture_event_t& ev)
 {
-    for (auto& gesture : this->gestures)
+    if (ev.type == touch::EVENT_TYPE_MOTION)
     {
-        if ((this->finger_state.fingers.size() == 1) &&
-            (ev.type == touch::EVENT_TYPE_TOUCH_DOWN))
+        // The gestures only look at the current position of each finger, so it is enough to pass them the
+        // last motion of each finger once per touch frame. The motions are kept in the order they arrived,
+        // so that gestures see them in the same order as without coalescing.
+        pending_gesture_motion.erase(std::remove_if(pending_gesture_motion.begin(),
+            pending_gesture_motion.end(), [&] (const auto& pending) { return pending.finger == ev.finger; }),
+            pending_gesture_motion.end());
+        pending_gesture_motion.push_back(ev);
+        return;
+    }
+
+    flush_gesture_motion();
+    if ((this->finger_state.fingers.size() == 1) &&
+        (ev.type == touch::EVENT_TYPE_TOUCH_DOWN))
+    {
+        // A new touch sequence starts, every gesture may match again.
+        this->active_gestures = this->gestures;
+        for (auto& gesture : this->active_gestures)
         {
             gesture->reset(ev.time);
         }
+    }
+
+    run_gestures(ev);
+}
 
+void wf::touch_interface_t::flush_gesture_motion()
+{
+    auto pending = std::move(pending_gesture_motion);
+    pending_gesture_motion.clear();
+    for (auto& ev : pending)
+    {
+        run_gestures(ev);
+    }
+}
+
+void wf::touch_interface_t::run_gestures(const wf::touch::gesture_event_t& ev)
+{
+    for (auto& gesture : this->active_gestures)
+    {
         gesture->update_state(ev);
     }
+
+    // Gestures which have completed or were cancelled (for example, because the wrong number of fingers
+    // was used, or an edge swipe did not start at the edge) ignore all events until the next touch
+    // sequence, so there is no need to keep passing events to them.
+    active_gestures.erase(std::remove_if(active_gestures.begin(), active_gestures.end(),
+        [] (const auto& gesture) { return gesture->get_status() != touch::GESTURE_STATUS_RUNNING; }),
+        active_gestures.end());
 }
 
 void wf::touch_interface_t::handle_touch_down(int32_t id, uint32_t time,
@@ -2,6 +2,7 @@
 #define TOUCH_HPP
 
 #include <map>
+#include <vector>
 #include <wayfire/touch/touch.hpp>
 #include "wayfire/scene-input.hpp"
 #include "wayfire/util.hpp"
@@ -73,6 +74,17 @@ class touch_interface_t
     void update_gestures(const wf::touch::gesture_event_t& event);
     std::vector<nonstd::observer_ptr<touch::gesture_t>> gestures;
 
+    /** Gestures which may still complete in the current touch sequence. */
+    std::vector<nonstd::observer_ptr<touch::gesture_t>> active_gestures;
+    void run_gestures(const wf::touch::gesture_event_t& event);
+
+    /**
+     * The last motion event of each finger which has not been passed to the gestures yet, in the order in
+     * which they arrived.
+     */
+    std::vector<touch::gesture_event_t> pending_gesture_motion;
+    void flush_gesture_motion();
+
     wf::signal::connection_t<wf::scene::root_node_update_signal>
     on_root_node_updated;
 
@@ -0,0 +1,133 @@
+#include "worker-pool.hpp"
+#include <wayfire/util/log.hpp>
+
+#include <algorithm>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+wf::worker_pool_t::worker_pool_t(wl_event_loop *loop, int max_threads)
+{
+    this->loop = loop;
+    this->max_threads = std::max(max_threads, 1);
+
+    completion_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (completion_fd < 0)
+    {
+        LOGE("Failed to create eventfd for the worker pool, background jobs will run synchronously.");
+        return;
+    }
+
+    completion_source = wl_event_loop_add_fd(loop, completion_fd, WL_EVENT_READABLE,
+        handle_completion, this);
+}
+
+wf::worker_pool_t::~worker_pool_t()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        queue.clear();
+    }
+
+    queue_changed.notify_all();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    if (completion_source)
+    {
+        wl_event_source_remove(completion_source);
+    }
+
+    if (completion_fd >= 0)
+    {
+        close(completion_fd);
+    }
+}
+
+void wf::worker_pool_t::submit(job_t job, job_t done)
+{
+    if (!completion_source)
+    {
+        // No way to get back to the main thread, fall back to running the job directly.
+        job();
+        if (done)
+        {
+            done();
+        }
+
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.emplace_back(std::move(job), std::move(done));
+        if ((int)threads.size() < max_threads)
+        {
+            threads.emplace_back([=] { run_worker(); });
+        }
+    }
+
+    queue_changed.notify_one();
+}
+
+void wf::worker_pool_t::run_worker()
+{
+    while (true)
+    {
+        std::pair<job_t, job_t> next;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            queue_changed.wait(lock, [=] { return stopping || !queue.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+
+            next = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        next.first();
+        next.first = nullptr;
+        if (next.second)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                completed.push_back(std::move(next.second));
+            }
+
+            uint64_t one = 1;
+            if (write(completion_fd, &one, sizeof(one)) != sizeof(one))
+            {
+                // The counter can only overflow if the main thread stopped reading it.
+                LOGE("Failed to signal worker job completion!");
+            }
+        }
+    }
+}
+
+int wf::worker_pool_t::handle_completion(int fd, uint32_t mask, void *data)
+{
+    auto self = (worker_pool_t*)data;
+
+    uint64_t count;
+    if (read(fd, &count, sizeof(count)) != sizeof(count))
+    {
+        return 0;
+    }
+
+    std::vector<job_t> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(self->mutex);
+        std::swap(callbacks, self->completed);
+    }
+
+    for (auto& callback : callbacks)
+    {
+        callback();
+    }
+
+    return 0;
+}
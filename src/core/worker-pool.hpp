@@ -0,0 +1,69 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <wayland-server-core.h>
+
+namespace wf
+{
+/**
+ * A small pool of background threads for work which does not touch any compositor state, for example
+ * decoding and encoding images.
+ *
+ * Jobs are executed on one of the worker threads, in no particular order. Their completion callbacks
+ * are dispatched on the main thread from the event loop, so they may freely use the rest of Wayfire.
+ */
+class worker_pool_t
+{
+  public:
+    using job_t = std::function<void ()>;
+
+    /**
+     * Create a new pool. The worker threads are started when the first job is submitted.
+     *
+     * @param loop The event loop which dispatches completion callbacks.
+     * @param max_threads The maximal number of worker threads.
+     */
+    worker_pool_t(wl_event_loop *loop, int max_threads);
+
+    /**
+     * Wait for the jobs which are currently running and stop the worker threads.
+     * Queued jobs which have not started yet and pending completion callbacks are discarded.
+     */
+    ~worker_pool_t();
+
+    worker_pool_t(const worker_pool_t&) = delete;
+    worker_pool_t(worker_pool_t&&) = delete;
+    worker_pool_t& operator =(const worker_pool_t&) = delete;
+    worker_pool_t& operator =(worker_pool_t&&) = delete;
+
+    /**
+     * Queue a job for execution on a worker thread.
+     *
+     * @param job The job to run. It must not access compositor state.
+     * @param done An optional callback to run on the main thread after the job has finished.
+     */
+    void submit(job_t job, job_t done = {});
+
+  private:
+    wl_event_loop *loop;
+    int max_threads;
+
+    std::mutex mutex;
+    std::condition_variable queue_changed;
+    std::deque<std::pair<job_t, job_t>> queue;
+    std::vector<job_t> completed;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+
+    int completion_fd = -1;
+    wl_event_source *completion_source = nullptr;
+
+    void run_worker();
+    static int handle_completion(int fd, uint32_t mask, void *data);
+};
+}
@@ -1,8 +1,11 @@
+#include <map>
+#include <set>
 #include <vector>
 #include "wayfire/debug.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include <string>
 #include <wayfire/config/file.hpp>
+#include <wayfire/config/compound-option.hpp>
 #include <wayfire/config-backend.hpp>
 #include <wayfire/plugin.hpp>
 #include <wayfire/core.hpp>
@@ -25,9 +28,104 @@ static void add_watch(int fd)
     wd_cfg_file = inotify_add_watch(fd, config_file.c_str(), IN_CLOSE_WRITE);
 }
 
-static void reload_config(int fd)
+using config_snapshot_t = std::map<std::string, std::string>;
+
+static std::string get_comparable_value(const std::shared_ptr<wf::config::option_base_t>& option)
+{
+    // Compound options (lists of tuples) do not have a string representation.
+    auto compound = std::dynamic_pointer_cast<wf::config::compound_option_t>(option);
+    if (!compound)
+    {
+        return option->get_value_str();
+    }
+
+    std::string value;
+    for (auto& tuple : compound->get_value_untyped())
+    {
+        for (auto& entry : tuple)
+        {
+            // Separate entries with characters which cannot appear in them.
+            value += entry + '\0';
+        }
+
+        value += '\n';
+    }
+
+    return value;
+}
+
+/**
+ * Get the current value of every option, keyed by "section/option".
+ */
+static config_snapshot_t snapshot_config()
 {
+    config_snapshot_t snapshot;
+    for (auto& section : cfg_manager->get_all_sections())
+    {
+        for (auto& option : section->get_registered_options())
+        {
+            snapshot.emplace(section->get_name() + "/" + option->get_name(), get_comparable_value(option));
+        }
+    }
+
+    return snapshot;
+}
+
+/**
+ * Find the sections which have options with different values, or options which exist only in
+ * one of the snapshots.
+ */
+static std::set<std::string> diff_sections(const config_snapshot_t& old_config,
+    const config_snapshot_t& new_config)
+{
+    std::set<std::string> changed;
+    auto add_section = [&] (const std::string& full_name)
+    {
+        changed.insert(full_name.substr(0, full_name.rfind('/')));
+    };
+
+    // Both maps are sorted, so walk them in lockstep.
+    auto old_it = old_config.begin();
+    auto new_it = new_config.begin();
+    while ((old_it != old_config.end()) || (new_it != new_config.end()))
+    {
+        if ((new_it == new_config.end()) ||
+            ((old_it != old_config.end()) && (old_it->first < new_it->first)))
+        {
+            add_section(old_it->first);
+            ++old_it;
+        } else if ((old_it == old_config.end()) || (new_it->first < old_it->first))
+        {
+            add_section(new_it->first);
+            ++new_it;
+        } else
+        {
+            if (old_it->second != new_it->second)
+            {
+                add_section(old_it->first);
+            }
+
+            ++old_it;
+            ++new_it;
+        }
+    }
+
+    return changed;
+}
+
+/**
+ * Reload the config file.
+ *
+ * Options whose values did not change are left untouched by wf-config, so their
+ * updated handlers do not fire.
+ *
+ * @return The sections in which options changed.
+ */
+static std::set<std::string> reload_config(int fd)
+{
+    auto old_config = snapshot_config();
     wf::config::load_configuration_options_from_file(*cfg_manager, config_file);
+    return diff_sections(old_config, snapshot_config());
 }
 
 static int handle_config_updated(int fd, uint32_t mask, void *data)
@@ -84,8 +182,14 @@ static int handle_config_updated(int fd, uint32_t mask, void *data)
     {
         LOGD("Reloading configuration file");
 
-        reload_config(fd);
         wf::reload_config_signal ev;
+        ev.changed_sections = reload_config(fd);
+        if (ev.changed_sections.empty())
+        {
+            LOGD("Configuration file reloaded, but no options changed");
+            return 0;
+        }
+
         wf::get_core().emit(&ev);
     }
 
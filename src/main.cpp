@@ -7,6 +7,7 @@
 
 #include <unistd.h>
 #include <wayfire/debug.hpp>
+#include <wayfire/trace.hpp>
 #include "main.hpp"
 
 #include <wayland-server.h>
@@ -37,6 +38,8 @@ static void print_help()
         " -D,  --damage-debug      enable additional debug for damaged regions" <<
         std::endl;
     std::cout << " -R,  --damage-rerender   rerender damaged regions" << std::endl;
+    std::cout << " -t,  --trace             write a trace of startup and other events " <<
+        "to the given file (Chrome trace format)" << std::endl;
     std::cout << " -v,  --version           print version and exit" << std::endl;
     exit(0);
 }
@@ -233,6 +236,18 @@ void parse_extended_debugging(const std::vector<std::string>& categories)
         {
             LOGD("Enabling extended debugging for render events");
             wf::log::enabled_categories.set((size_t)wf::log::logging_category::RENDER, 1);
+        } else if (cat == "plugins")
+        {
+            LOGD("Enabling extended debugging for plugin loading");
+            wf::log::enabled_categories.set((size_t)wf::log::logging_category::PLUGINS, 1);
+        } else if (cat == "trace")
+        {
+            LOGD("Enabling extended debugging for trace events");
+            wf::log::enabled_categories.set((size_t)wf::log::logging_category::TRACE, 1);
+        } else if (cat == "gpu")
+        {
+            LOGD("Enabling extended debugging for GPU resource allocation");
+            wf::log::enabled_categories.set((size_t)wf::log::logging_category::GPU, 1);
         } else
         {
             LOGE("Unrecognized debugging category \"", cat, "\"");
@@ -272,17 +287,19 @@ int main(int argc, char *argv[])
         {"debug", optional_argument, NULL, 'd'},
         {"damage-debug", no_argument, NULL, 'D'},
         {"damage-rerender", no_argument, NULL, 'R'},
+        {"trace", required_argument, NULL, 't'},
         {"help", no_argument, NULL, 'h'},
         {"version", no_argument, NULL, 'v'},
         {0, 0, NULL, 0}
     };
 
     std::string config_file;
+    std::string trace_file;
     std::string config_backend = WF_DEFAULT_CONFIG_BACKEND;
     std::vector<std::string> extended_debug_categories;
 
     int c, i;
-    while ((c = getopt_long(argc, argv, "c:B:d::DhRv", opts, &i)) != -1)
+    while ((c = getopt_long(argc, argv, "c:B:d::DhRt:v", opts, &i)) != -1)
     {
         switch (c)
         {
@@ -302,6 +319,10 @@ int main(int argc, char *argv[])
             runtime_config.no_damage_track = true;
             break;
 
+          case 't':
+            trace_file = optarg;
+            break;
+
           case 'h':
             print_help();
             break;
@@ -342,6 +363,11 @@ int main(int argc, char *argv[])
     wf::log::initialize_logging(std::cout, log_level, detect_color_mode());
 
     parse_extended_debugging(extended_debug_categories);
+    if (!trace_file.empty())
+    {
+        wf::trace::start(trace_file);
+    }
+
     wlr_log_init(WLR_DEBUG, wlr_log_handler);
 
 #ifdef PRINT_TRACE
@@ -374,7 +400,11 @@ int main(int argc, char *argv[])
     /** TODO: move this to core_impl constructor */
     core.display = display;
     core.ev_loop = wl_display_get_event_loop(core.display);
-    core.backend = wlr_backend_autocreate(core.display, &core.session);
+    {
+        WF_TRACE_SCOPE("backend create");
+        core.backend = wlr_backend_autocreate(core.display, &core.session);
+    }
+
     //int drm_fd = wlr_backend_get_drm_fd(core.backend);
     // if (drm_fd < 0)
     // {
@@ -393,7 +423,11 @@ int main(int argc, char *argv[])
     //         return EXIT_FAILURE;
     //     }
     // }
-    core.renderer = wlr_renderer_autocreate(core.backend);
+    {
+        WF_TRACE_SCOPE("renderer create");
+        core.renderer = wlr_renderer_autocreate(core.backend);
+    }
+
     wlr_android_renderer_init_wl_display (core.renderer, core.display);
     assert(core.renderer);
     core.allocator = wlr_allocator_autocreate(core.backend, core.renderer);
@@ -421,7 +455,11 @@ int main(int argc, char *argv[])
 
     LOGD("Using configuration backend: ", config_backend);
     core.config_backend = std::unique_ptr<wf::config_backend_t>(backend);
-    core.config_backend->init(display, core.config, config_file);
+    {
+        WF_TRACE_SCOPE("config backend init");
+        core.config_backend->init(display, core.config, config_file);
+    }
+
     core.init();
 
     auto socket = choose_socket(core.display);
@@ -434,7 +472,13 @@ int main(int argc, char *argv[])
 
     core.wayland_display = socket.value();
     LOGI("Using socket name ", core.wayland_display);
-    if (!wlr_backend_start(core.backend))
+    bool backend_started;
+    {
+        WF_TRACE_SCOPE("backend start");
+        backend_started = wlr_backend_start(core.backend);
+    }
+
+    if (!backend_started)
     {
         LOGE("Failed to initialize backend, exiting");
         wlr_backend_destroy(core.backend);
@@ -456,6 +500,7 @@ int main(int argc, char *argv[])
     }
 
     wf::compositor_core_impl_t::deallocate_core();
+    wf::trace::stop();
     LOGI("Shutdown successful!");
     return EXIT_SUCCESS;
 }
@@ -2,13 +2,16 @@
 #include "pixman.h"
 #include "wayfire/core.hpp"
 #include "wayfire/debug.hpp"
+#include "wayfire/trace.hpp"
 #include "wayfire/geometry.hpp"
+#include "wayfire/gpu-resources.hpp"
 #include "wayfire/region.hpp"
 #include "wayfire/scene-render.hpp"
 #include "wayfire/scene.hpp"
 #include "wayfire/signal-definitions.hpp"
 #include "wayfire/view.hpp"
 #include "wayfire/output.hpp"
+#include "wayfire/output-layout.hpp"
 #include "wayfire/util.hpp"
 #include "../core/opengl-priv.hpp"
 #include "../main.hpp"
@@ -696,6 +699,7 @@ class depth_buffer_manager_t
     {
         if (buffer.tex != (GLuint) - 1)
         {
+            wf::gpu_resources::untrack_texture(buffer.tex);
             GL_CALL(glDeleteTextures(1, &buffer.tex));
         }
     }
@@ -725,6 +729,7 @@ class depth_buffer_manager_t
         GL_CALL(glBindTexture(GL_TEXTURE_2D, buffer.tex));
         GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT,
             width, height, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL));
+        wf::gpu_resources::track_texture(buffer.tex, width, height, __builtin_return_address(0));
         buffer.width  = width;
         buffer.height = height;
 
@@ -877,6 +882,14 @@ struct repaint_delay_manager_t
         last_pageflip = get_current_time();
     }
 
+    /**
+     * @return The refresh interval of the output in nanoseconds, or 0 if unknown.
+     */
+    int64_t get_refresh_nsec() const
+    {
+        return refresh_nsec;
+    }
+
     /**
      * @return The delay in milliseconds for the current frame.
      */
@@ -926,13 +939,45 @@ struct repaint_delay_manager_t
     // Time of last frame
     int64_t last_pageflip = -1; // -1 is invalid
 
-    int64_t refresh_nsec;
+    int64_t refresh_nsec = 0;
     wf::option_wrapper_t<int> max_render_time{"core/max_render_time"};
     wf::option_wrapper_t<bool> dynamic_delay{"workarounds/dynamic_repaint_delay"};
 
     wf::wl_listener_wrapper on_present;
 };
 
+/**
+ * Outputs whose frames are due in the same iteration of the event loop, for example the outputs of a video
+ * wall which refresh together, are painted together.
+ *
+ * First, all of them are prepared, which runs animations and pre-render hooks. These may change the
+ * scenegraph, so doing it for all outputs before rendering means that all outputs show the same state of
+ * the scene, and that the render instances of an output are not regenerated in the middle of the batch.
+ * Then the outputs are rendered and committed one after another, and finally the post-render hooks run and
+ * the frame-done signals are emitted.
+ *
+ * With a single output there is nothing to batch, so the output is painted right away.
+ */
+class frame_batch_t
+{
+  public:
+    static frame_batch_t& get();
+
+    /** Paint the output the next time the event loop goes idle, or immediately if it is the only output. */
+    void schedule_paint(wf::render_manager::impl *output);
+    /** Remove an output which is going to be destroyed. */
+    void cancel_paint(wf::render_manager::impl *output);
+
+  private:
+    frame_batch_t();
+
+    std::vector<wf::render_manager::impl*> due;
+    std::vector<wf::render_manager::impl*> painting;
+    wf::wl_idle_call idle_paint;
+
+    void paint_all();
+};
+
 class wf::render_manager::impl
 {
   public:
@@ -949,6 +994,16 @@ class wf::render_manager::impl
 
     wf::option_wrapper_t<wf::color_t> background_color_opt;
 
+    // Whether the first frame of the output has been recorded in the trace.
+    bool traced_first_frame = false;
+
+    wf::safe_list_t<animation_hook_t*> animations;
+    // Updates the animations while the output is suspended and frames may not arrive.
+    wf::wl_timer<true> suspended_animation_timer;
+    static constexpr int SUSPENDED_ANIMATION_INTERVAL = 100; // ms
+    // The time when the last frame event arrived.
+    std::chrono::steady_clock::time_point frame_start;
+
     impl(output_t *o) : output(o), env_allow_scanout(check_scanout_enabled())
     {
         damage_manager = std::make_unique<swapchain_damage_manager_t>(o);
@@ -959,27 +1014,24 @@ class wf::render_manager::impl
 
         on_frame.set_callback([&] (void*)
         {
+            frame_start = std::chrono::steady_clock::now();
             delay_manager->start_frame();
 
             auto repaint_delay = delay_manager->get_delay();
+            // Until the output is painted, wlroots should not send more frame events.
+            output->handle->frame_pending = true;
             // Leave a bit of time for clients to render, see
             // https://github.com/swaywm/sway/pull/4588
             if (repaint_delay < 1)
             {
-                output->handle->frame_pending = false;
-                paint();
+                frame_batch_t::get().schedule_paint(this);
             } else
             {
-                output->handle->frame_pending = true;
                 repaint_timer.set_timeout(repaint_delay, [=] ()
                 {
-                    output->handle->frame_pending = false;
-                    paint();
+                    frame_batch_t::get().schedule_paint(this);
                 });
             }
-
-            frame_done_signal ev;
-            output->emit(&ev);
         });
 
         on_frame.connect(&output->handle->events.frame);
@@ -993,6 +1045,11 @@ class wf::render_manager::impl
         damage_manager->schedule_repaint();
     }
 
+    ~impl()
+    {
+        frame_batch_t::get().cancel_paint(this);
+    }
+
     const bool env_allow_scanout;
     static bool check_scanout_enabled()
     {
@@ -1020,6 +1077,79 @@ class wf::render_manager::impl
         }
     }
 
+    void add_animation(animation_hook_t *hook)
+    {
+        animations.push_back(hook);
+        damage_manager->schedule_repaint();
+        if (suspended_animation_timer.is_connected())
+        {
+            return;
+        }
+
+        suspended_animation_timer.set_timeout(SUSPENDED_ANIMATION_INTERVAL, [=] ()
+        {
+            if (is_suspended())
+            {
+                run_animations();
+            }
+
+            return animations.size() > 0;
+        });
+    }
+
+    void rem_animation(animation_hook_t *hook)
+    {
+        animations.remove_all(hook);
+    }
+
+    bool is_suspended() const
+    {
+        return (output_inhibit_counter > 0) || !output->handle->enabled;
+    }
+
+    /**
+     * Predict when the frame which is currently being prepared will be presented: one refresh cycle after
+     * the frame event, or now if the output is suspended.
+     */
+    std::chrono::steady_clock::time_point predict_presentation_time()
+    {
+        auto now     = std::chrono::steady_clock::now();
+        auto refresh = delay_manager->get_refresh_nsec();
+        if (is_suspended() || (refresh <= 0))
+        {
+            return now;
+        }
+
+        return std::max(now, frame_start + std::chrono::nanoseconds(refresh));
+    }
+
+    /**
+     * Update all animations on the output for the next frame, and emit their damage.
+     */
+    void run_animations()
+    {
+        if (animations.size() == 0)
+        {
+            return;
+        }
+
+        WF_TRACE_SCOPE("animations");
+        animation_frame_t frame;
+        frame.output    = output;
+        frame.suspended = is_suspended();
+        frame.presentation_time = predict_presentation_time();
+        animations.for_each([&] (animation_hook_t*& hook)
+        {
+            (*hook)(frame);
+        });
+
+        frame.flush_damage();
+        if ((animations.size() > 0) && !frame.suspended)
+        {
+            damage_manager->schedule_repaint();
+        }
+    }
+
     /* Actual rendering functions */
 
     /**
@@ -1117,19 +1247,34 @@ class wf::render_manager::impl
     }
 
     /**
-     * Repaints the whole output, includes all effects and hooks
+     * Frame setup: update animations, run pre-render hooks and query damage.
+     * This is the part of a repaint which may change the scenegraph.
      */
-    void paint()
+    void prepare_frame()
     {
-        /* Part 1: frame setup: query damage, etc. */
+        WF_TRACE_SCOPE("prepare frame");
+        output->handle->frame_pending = false;
+
+        /* Part 1: frame setup: update animations, query damage, etc. */
+        run_animations();
         effects->run_effects(OUTPUT_EFFECT_PRE);
         effects->run_effects(OUTPUT_EFFECT_DAMAGE);
+    }
 
+    /**
+     * Render the output after prepare_frame(), including overlay and postprocessing effects, and commit the
+     * new frame.
+     *
+     * @return Whether a frame was rendered, and post_paint() needs to be called.
+     */
+    bool render_frame()
+    {
+        WF_TRACE_SCOPE("paint");
         if (do_direct_scanout())
         {
             // Yet another optimization: if we can directly scanout, we should
             // stop the rest of the repaint cycle.
-            return;
+            return false;
         }
 
         auto next_frame = damage_manager->start_frame();
@@ -1138,7 +1283,7 @@ class wf::render_manager::impl
             // Optimization: the output doesn't need a new frame (so isn't damaged), so we can
             // just skip the whole repaint
             delay_manager->skip_frame();
-            return;
+            return false;
         }
 
         /* Part 2: call the renderer, which sets swap_damage and draws the scenegraph */
@@ -1182,12 +1327,37 @@ class wf::render_manager::impl
         // assert(r->rendering) or assert(!r->rendering) in wlroots/renderer/wlr_renderer.c always fails with hwc backend in wlroots
         output->handle->renderer->rendering = true;
         damage_manager->swap_buffers(std::move(next_frame), swap_damage);
+        if (!traced_first_frame && wf::trace::is_enabled())
+        {
+            traced_first_frame = true;
+            wf::trace::record_instant("first frame on " + output->to_string());
+        }
 
         // assert(r->rendering) or assert(!r->rendering) in wlroots/renderer/wlr_renderer.c always fails with hwc backend in wlroots
         output->handle->renderer->rendering = false;
         OpenGL::unbind_output(output);
         swap_damage.clear();
-        post_paint();
+        return true;
+    }
+
+    /**
+     * Repaint the output on its own, outside of a batch, and finish the frame.
+     */
+    void paint()
+    {
+        prepare_frame();
+        if (render_frame())
+        {
+            post_paint();
+        }
+
+        emit_frame_done();
+    }
+
+    void emit_frame_done()
+    {
+        frame_done_signal ev;
+        output->emit(&ev);
     }
 
     /**
@@ -1203,6 +1373,84 @@ class wf::render_manager::impl
     }
 };
 
+frame_batch_t& frame_batch_t::get()
+{
+    // Never destroyed, the idle call must not outlive the event loop.
+    static frame_batch_t *batch = new frame_batch_t();
+    return *batch;
+}
+
+frame_batch_t::frame_batch_t()
+{
+    idle_paint.set_callback([=] () { paint_all(); });
+}
+
+void frame_batch_t::schedule_paint(wf::render_manager::impl *output)
+{
+    if (due.empty() && painting.empty() && (wf::get_core().output_layout->get_num_outputs() <= 1))
+    {
+        output->paint();
+        return;
+    }
+
+    if (std::find(due.begin(), due.end(), output) == due.end())
+    {
+        due.push_back(output);
+    }
+
+    idle_paint.run_once();
+}
+
+void frame_batch_t::cancel_paint(wf::render_manager::impl *output)
+{
+    due.erase(std::remove(due.begin(), due.end(), output), due.end());
+    std::replace(painting.begin(), painting.end(), output, (wf::render_manager::impl*)nullptr);
+    if (due.empty())
+    {
+        idle_paint.disconnect();
+    }
+}
+
+void frame_batch_t::paint_all()
+{
+    WF_TRACE_SCOPE("paint outputs");
+    painting = std::move(due);
+    due.clear();
+
+    for (auto& output : painting)
+    {
+        if (output)
+        {
+            output->prepare_frame();
+        }
+    }
+
+    std::vector<bool> rendered(painting.size(), false);
+    for (size_t i = 0; i < painting.size(); i++)
+    {
+        rendered[i] = painting[i] && painting[i]->render_frame();
+    }
+
+    for (size_t i = 0; i < painting.size(); i++)
+    {
+        if (painting[i] && rendered[i])
+        {
+            painting[i]->post_paint();
+        }
+    }
+
+    // Like a single output, each output of the batch signals that its frame is done after painting it.
+    for (auto& output : painting)
+    {
+        if (output)
+        {
+            output->emit_frame_done();
+        }
+    }
+
+    painting.clear();
+}
+
 wf::region_t scene::run_render_pass(
     const render_pass_params_t& params, uint32_t flags)
 {
@@ -1321,6 +1569,49 @@ void render_manager::rem_effect(effect_hook_t *hook)
     pimpl->effects->rem_effect(hook);
 }
 
+void render_manager::add_animation(animation_hook_t *hook)
+{
+    pimpl->add_animation(hook);
+}
+
+void render_manager::rem_animation(animation_hook_t *hook)
+{
+    pimpl->rem_animation(hook);
+}
+
+void animation_frame_t::damage_node(const scene::node_ptr& node)
+{
+    if (!damaged_nodes.count(node))
+    {
+        damaged_nodes[node] = node->get_bounding_box();
+    }
+}
+
+void animation_frame_t::flush_damage(const scene::node_ptr& node)
+{
+    auto it = damaged_nodes.find(node);
+    if (it == damaged_nodes.end())
+    {
+        return;
+    }
+
+    auto region = std::move(it->second);
+    damaged_nodes.erase(it);
+    region |= node->get_bounding_box();
+    scene::damage_node(node, region);
+}
+
+void animation_frame_t::flush_damage()
+{
+    auto nodes = std::move(damaged_nodes);
+    damaged_nodes.clear();
+    for (auto& [node, region] : nodes)
+    {
+        region |= node->get_bounding_box();
+        scene::damage_node(node, region);
+    }
+}
+
 void render_manager::add_post(post_hook_t *hook)
 {
     pimpl->postprocessing->add_post(hook);
@@ -0,0 +1,145 @@
+#include <wayfire/trace.hpp>
+#include <wayfire/util/log.hpp>
+
+#include <cstdio>
+#include <mutex>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+std::atomic<bool> wf::trace::detail::recording{false};
+
+namespace
+{
+struct trace_file_t
+{
+    std::mutex mutex;
+    FILE *file = nullptr;
+    wf::trace::trace_clock::time_point origin;
+    bool first_event = true;
+};
+
+trace_file_t trace_file;
+
+int64_t to_trace_timestamp(wf::trace::trace_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(time - trace_file.origin).count();
+}
+
+std::string escape_json(std::string_view text)
+{
+    std::string result;
+    result.reserve(text.size());
+    for (char c : text)
+    {
+        if ((c == '"') || (c == '\\'))
+        {
+            result += '\\';
+            result += c;
+        } else if ((unsigned char)c < 0x20)
+        {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            result += buf;
+        } else
+        {
+            result += c;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Write a single event to the trace file. @fields are the event-specific fields, without the enclosing
+ * braces.
+ */
+void write_event(const std::string& fields)
+{
+    std::lock_guard<std::mutex> lock(trace_file.mutex);
+    if (!trace_file.file)
+    {
+        return;
+    }
+
+    fprintf(trace_file.file, "%s{%s,\"pid\":%d,\"tid\":%ld}",
+        trace_file.first_event ? "" : ",\n", fields.c_str(), (int)getpid(), (long)syscall(SYS_gettid));
+    trace_file.first_event = false;
+}
+}
+
+bool wf::trace::start(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(trace_file.mutex);
+    trace_file.file = fopen(path.c_str(), "w");
+    if (!trace_file.file)
+    {
+        LOGE("Failed to open trace file ", path);
+        return false;
+    }
+
+    trace_file.origin = trace_clock::now();
+    trace_file.first_event = false;
+    fprintf(trace_file.file, "[\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%ld,"
+                             "\"args\":{\"name\":\"wayfire\"}}",
+        (int)getpid(), (long)syscall(SYS_gettid));
+    fprintf(trace_file.file, ",\n{\"name\":\"trace start\",\"ph\":\"i\",\"s\":\"g\",\"ts\":0,\"pid\":%d,"
+                             "\"tid\":%ld,\"args\":{\"steady_clock_us\":%lld}}",
+        (int)getpid(), (long)syscall(SYS_gettid),
+        (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+            trace_file.origin.time_since_epoch()).count());
+
+    detail::recording = true;
+    return true;
+}
+
+void wf::trace::stop()
+{
+    std::lock_guard<std::mutex> lock(trace_file.mutex);
+    if (!trace_file.file)
+    {
+        return;
+    }
+
+    // The closing bracket is optional in the format, so a trace is still usable if Wayfire crashes.
+    fprintf(trace_file.file, "\n]\n");
+    fclose(trace_file.file);
+    trace_file.file = nullptr;
+    detail::recording = false;
+}
+
+void wf::trace::record_span(std::string_view name, trace_clock::time_point start, trace_clock::time_point end)
+{
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    LOGC(TRACE, std::string(name), " took ", duration / 1000.0, "ms");
+    if (!is_recording())
+    {
+        return;
+    }
+
+    write_event("\"name\":\"" + escape_json(name) + "\",\"ph\":\"X\",\"ts\":" +
+        std::to_string(to_trace_timestamp(start)) + ",\"dur\":" + std::to_string(duration));
+}
+
+void wf::trace::record_counter(std::string_view name, int64_t value)
+{
+    if (!is_recording())
+    {
+        return;
+    }
+
+    write_event("\"name\":\"" + escape_json(name) + "\",\"ph\":\"C\",\"ts\":" +
+        std::to_string(to_trace_timestamp(trace_clock::now())) +
+        ",\"args\":{\"value\":" + std::to_string(value) + "}");
+}
+
+void wf::trace::record_instant(std::string_view name)
+{
+    LOGC(TRACE, std::string(name));
+    if (!is_recording())
+    {
+        return;
+    }
+
+    write_event("\"name\":\"" + escape_json(name) + "\",\"ph\":\"i\",\"s\":\"g\",\"ts\":" +
+        std::to_string(to_trace_timestamp(trace_clock::now())));
+}
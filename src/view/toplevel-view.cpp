@@ -237,6 +237,7 @@ void wf::toplevel_view_interface_t::set_minimized(bool minim)
     this->minimized = minim;
     wf::scene::set_node_enabled(get_root_node(), !minimized);
 
+    priv->bump_properties_version();
     view_minimized_signal data;
     data.view = {this};
     this->emit(&data);
@@ -277,6 +278,7 @@ void wf::toplevel_view_interface_t::set_sticky(bool sticky)
 void wf::toplevel_view_interface_t::set_activated(bool active)
 {
     activated = active;
+    priv->bump_properties_version();
     view_activated_state_signal ev;
     ev.view = {this};
     this->emit(&ev);
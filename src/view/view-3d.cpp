@@ -11,6 +11,7 @@
 #include "wayfire/output.hpp"
 #include <glm/ext/matrix_transform.hpp>
 #include <string>
+#include <typeinfo>
 #include <tuple>
 #include <wayfire/view.hpp>
 #include <algorithm>
@@ -99,7 +100,10 @@ void transform_manager_node_t::_rem_transformer(
 view_2d_transformer_t::view_2d_transformer_t(wayfire_view view) :
     transformer_base_node_t(false)
 {
-    this->view = view->weak_from_this();
+    if (view)
+    {
+        this->view = view->weak_from_this();
+    }
 }
 
 static wf::pointf_t get_center(wf::geometry_t view)
@@ -134,6 +138,31 @@ static void rotate_xy(double& x, double& y, double angle)
     std::tie(x, y) = std::make_tuple(cs * x - sn * y, sn * x + cs * y);
 }
 
+glm::mat4 view_2d_transformer_t::get_affine_transform()
+{
+    auto midpoint  = get_center(view);
+    auto center_at = glm::translate(glm::mat4(1.0),
+        {-midpoint.x, -midpoint.y, 0.0});
+    auto scale = glm::scale(glm::mat4(1.0),
+        glm::vec3{scale_x, scale_y, 1.0});
+    auto rotate = glm::rotate<float>(glm::mat4(1.0), -angle,
+        glm::vec3{0.0, 0.0, 1.0});
+    auto translate = glm::translate(glm::mat4(1.0),
+        glm::vec3{translation_x + midpoint.x,
+            translation_y + midpoint.y, 0.0});
+    return translate * rotate * scale * center_at;
+}
+
+float view_2d_transformer_t::get_alpha_multiplier()
+{
+    return alpha;
+}
+
+bool view_2d_transformer_t::can_fuse()
+{
+    return typeid(*this) == typeid(view_2d_transformer_t);
+}
+
 wf::pointf_t view_2d_transformer_t::to_local(const wf::pointf_t& point)
 {
     auto midpoint = get_center(view);
@@ -203,21 +232,23 @@ class view_2d_render_instance_t :
         const wf::region_t& region) override
     {
         // Untransformed bounding box
-        auto bbox = self->get_children_bounding_box();
-        auto tex  = this->get_texture(target.scale);
-
-        auto midpoint  = get_center(self->view);
-        auto center_at = glm::translate(glm::mat4(1.0),
-            {-midpoint.x, -midpoint.y, 0.0});
-        auto scale = glm::scale(glm::mat4(1.0),
-            glm::vec3{self->scale_x, self->scale_y, 1.0});
-        auto rotate = glm::rotate<float>(glm::mat4(1.0), -self->angle,
-            glm::vec3{0.0, 0.0, 1.0});
-        auto translate = glm::translate(glm::mat4(1.0),
-            glm::vec3{self->translation_x + midpoint.x,
-                self->translation_y + midpoint.y, 0.0});
+        auto bbox  = self->get_children_bounding_box();
         auto ortho = target.get_orthographic_projection();
-        auto full_matrix = ortho * translate * rotate * scale * center_at;
+        auto full_matrix = ortho * self->get_affine_transform();
+        float alpha = self->alpha;
+
+        wf::texture_t tex;
+        if (auto fused = this->fused_texture())
+        {
+            // Render the transformers below us directly, e.g. alpha + scale + move-drag.
+            tex   = fused->texture;
+            bbox  = fused->geometry;
+            full_matrix = full_matrix * fused->transform;
+            alpha *= fused->alpha;
+        } else
+        {
+            tex = this->get_texture(target.scale);
+        }
 
         OpenGL::render_begin(target);
         for (auto& box : region)
@@ -225,7 +256,7 @@ class view_2d_render_instance_t :
             target.logic_scissor(wlr_box_from_pixman_box(box));
             // OpenGL::clear({1, 0, 0, 1});
             OpenGL::render_transformed_texture(tex, bbox, full_matrix,
-                glm::vec4{1.0, 1.0, 1.0, self->alpha});
+                glm::vec4{1.0, 1.0, 1.0, alpha});
         }
 
         OpenGL::render_end();
@@ -19,6 +19,7 @@
 
 void wf::view_implementation::emit_view_map_signal(wayfire_view view, bool has_position)
 {
+    view->priv->bump_properties_version();
     wf::view_mapped_signal data;
     data.view = view;
     data.is_positioned = has_position;
@@ -61,6 +62,7 @@ void wf::view_interface_t::emit_view_map()
 
 void wf::view_interface_t::emit_view_unmap()
 {
+    priv->bump_properties_version();
     view_unmapped_signal data;
     data.view = self();
 
@@ -94,6 +96,7 @@ void wf::view_interface_t::emit_view_pre_unmap()
 
 void wf::view_implementation::emit_title_changed_signal(wayfire_view view)
 {
+    view->priv->bump_properties_version();
     view_title_changed_signal data;
     data.view = view;
     view->emit(&data);
@@ -102,6 +105,7 @@ void wf::view_implementation::emit_title_changed_signal(wayfire_view view)
 
 void wf::view_implementation::emit_app_id_changed_signal(wayfire_view view)
 {
+    view->priv->bump_properties_version();
     view_app_id_changed_signal data;
     data.view = view;
     view->emit(&data);
@@ -52,6 +52,11 @@ class view_interface_t::view_priv_impl
     std::weak_ptr<wf::workspace_set_t> current_wset;
     std::shared_ptr<toplevel_t> toplevel;
     wf::signal::connection_t<destruct_signal<view_interface_t>> pre_free;
+
+    /** See view_interface_t::get_properties_version(). */
+    uint64_t properties_version = 0;
+    /** Call before emitting a signal for a change of the properties, see get_properties_version(). */
+    void bump_properties_version();
 };
 
 /**
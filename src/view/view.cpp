@@ -125,6 +125,18 @@ void wf::view_interface_t::take_snapshot(wf::render_target_t& target)
 wf::view_interface_t::view_interface_t()
 {
     this->priv = std::make_unique<wf::view_interface_t::view_priv_impl>();
+    this->priv->bump_properties_version();
+}
+
+uint64_t wf::view_interface_t::get_properties_version() const
+{
+    return priv->properties_version;
+}
+
+void wf::view_interface_t::view_priv_impl::bump_properties_version()
+{
+    static uint64_t counter = 0;
+    properties_version = ++counter;
 }
 
 class sentinel_node_t : public wf::scene::node_t
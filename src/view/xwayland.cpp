@@ -1,4 +1,5 @@
 #include <wayfire/util/log.hpp>
+#include <wayfire/trace.hpp>
 #include <wayfire/nonstd/wlroots-full.hpp>
 #include "wayfire/core.hpp"
 #include "../core/core-impl.hpp"
@@ -218,6 +219,7 @@ static wf::wl_listener_wrapper on_xwayland_ready;
 void wf::init_xwayland(bool lazy)
 {
 #if WF_HAS_XWAYLAND
+    WF_TRACE_SCOPE("xwayland init");
     on_xwayland_surface_created.set_callback([] (void *data)
     {
         wf::new_xwayland_surface_signal ev;
@@ -233,6 +235,7 @@ void wf::init_xwayland(bool lazy)
 
     on_xwayland_ready.set_callback([&] (void *data)
     {
+        WF_TRACE_INSTANT("xwayland ready");
         if (!wf::xw::load_basic_atoms(xwayland_handle->display_name))
         {
             LOGE("Failed to load Xwayland atoms.");
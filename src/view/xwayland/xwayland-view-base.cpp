@@ -140,4 +140,15 @@ bool wf::xwayland_view_base_t::is_focusable() const
     return kb_focus_enabled;
 }
 
+wf::xwayland_configure_stats_t& wf::xwayland_view_base_t::get_configure_stats()
+{
+    return configure_stats;
+}
+
+wf::xwayland_configure_stats_t& wf::xwayland_view_base_t::get_total_configure_stats()
+{
+    static xwayland_configure_stats_t total;
+    return total;
+}
+
 #endif
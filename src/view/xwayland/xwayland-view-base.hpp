@@ -7,10 +7,13 @@
 #include <wayfire/signal-definitions.hpp>
 
 #include "wayfire/util.hpp"
+#include "wayfire/output.hpp"
+#include "wayfire/render-manager.hpp"
 #include "xwayland-helpers.hpp"
 #include <wayfire/scene-operations.hpp>
 #include <wayfire/view-helpers.hpp>
 #include <wayfire/unstable/xwl-toplevel-base.hpp>
+#include <optional>
 
 #if WF_HAS_XWAYLAND
 
@@ -23,6 +26,111 @@ class wayfire_xwayland_view_internal_base : public wf::xwayland_view_base_t
     /** The geometry requested by the client */
     bool self_positioned = false;
 
+    /**
+     * The latest configure request which has not been handled yet, see queue_client_configure(), and
+     * whether it replaced earlier requests.
+     */
+    std::optional<wlr_xwayland_surface_configure_event> pending_configure;
+    bool pending_configure_coalesced = false;
+
+    /** The output whose next frame flushes the pending configure request. */
+    wf::output_t *configure_output = nullptr;
+
+    wf::effect_hook_t on_configure_frame = [=] ()
+    {
+        flush_client_configure();
+    };
+
+    wf::signal::connection_t<wf::output_pre_remove_signal> on_configure_output_removed =
+        [=] (wf::output_pre_remove_signal *ev)
+    {
+        flush_client_configure();
+    };
+
+    /**
+     * Handle a configure request from the client.
+     *
+     * Some clients send a configure request for every motion event while they are being resized, and
+     * handling each of them means a new transaction and geometry signals for the view. So, as long as the
+     * view is mapped, requests are only recorded, and the latest one is handled right before the view's
+     * output paints its next frame. Requests of unmapped views are handled immediately, as they determine
+     * the initial position of the view.
+     */
+    void queue_client_configure(wlr_xwayland_surface_configure_event *ev)
+    {
+        configure_stats.requests++;
+        get_total_configure_stats().requests++;
+
+        auto output = get_output();
+        if (!is_mapped() || !output || !output->handle->enabled)
+        {
+            flush_client_configure();
+            handle_client_configure(ev);
+            return;
+        }
+
+        if (pending_configure)
+        {
+            // Keep the fields from the earlier request which the new request does not set.
+            auto& pending = *pending_configure;
+            pending.x = (ev->mask & XCB_CONFIG_WINDOW_X) ? ev->x : pending.x;
+            pending.y = (ev->mask & XCB_CONFIG_WINDOW_Y) ? ev->y : pending.y;
+            pending.width  = (ev->mask & XCB_CONFIG_WINDOW_WIDTH) ? ev->width : pending.width;
+            pending.height = (ev->mask & XCB_CONFIG_WINDOW_HEIGHT) ? ev->height : pending.height;
+            pending.mask  |= ev->mask;
+            pending_configure_coalesced = true;
+
+            configure_stats.coalesced++;
+            get_total_configure_stats().coalesced++;
+        } else
+        {
+            pending_configure = *ev;
+        }
+
+        if (configure_output != output)
+        {
+            disconnect_configure_frame();
+            output->render->add_effect(&on_configure_frame, wf::OUTPUT_EFFECT_PRE);
+            output->connect(&on_configure_output_removed);
+            configure_output = output;
+        }
+
+        output->render->schedule_redraw();
+    }
+
+    /**
+     * Handle the pending configure request, if any.
+     */
+    void flush_client_configure()
+    {
+        disconnect_configure_frame();
+        if (!pending_configure)
+        {
+            return;
+        }
+
+        auto ev = *pending_configure;
+        pending_configure.reset();
+        if (pending_configure_coalesced)
+        {
+            pending_configure_coalesced = false;
+            configure_stats.coalesced_batches++;
+            get_total_configure_stats().coalesced_batches++;
+        }
+
+        handle_client_configure(&ev);
+    }
+
+    void disconnect_configure_frame()
+    {
+        if (configure_output)
+        {
+            configure_output->render->rem_effect(&on_configure_frame);
+            on_configure_output_removed.disconnect();
+            configure_output = nullptr;
+        }
+    }
+
   public:
     wayfire_xwayland_view_internal_base(wlr_xwayland_surface *xww) : xwayland_view_base_t(xww)
     {}
@@ -38,7 +146,7 @@ class wayfire_xwayland_view_internal_base : public wf::xwayland_view_base_t
     {
         on_configure.set_callback([&] (void *data)
         {
-            handle_client_configure((wlr_xwayland_surface_configure_event*)data);
+            queue_client_configure((wlr_xwayland_surface_configure_event*)data);
         });
 
         on_configure.connect(&xw->events.request_configure);
@@ -52,6 +160,8 @@ class wayfire_xwayland_view_internal_base : public wf::xwayland_view_base_t
 
     void destroy() override
     {
+        pending_configure.reset();
+        disconnect_configure_frame();
         wf::xwayland_view_base_t::destroy();
         on_configure.disconnect();
     }
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace wf
+{
+namespace bench
+{
+/**
+ * A minimal blocking client for Wayfire's IPC socket: every message is a 32-bit length in native byte
+ * order, followed by the JSON message.
+ */
+class ipc_client_t
+{
+  public:
+    ipc_client_t() = default;
+    ipc_client_t(const ipc_client_t&) = delete;
+    ipc_client_t& operator =(const ipc_client_t&) = delete;
+
+    ~ipc_client_t()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    /**
+     * Connect to the socket, retrying until it appears or the timeout expires.
+     */
+    bool connect(const std::string& path, std::chrono::milliseconds timeout)
+    {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            sockaddr_un addr;
+            std::memset(&addr, 0, sizeof(addr));
+            addr.sun_family = AF_UNIX;
+            std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+            if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) == 0)
+            {
+                return true;
+            }
+
+            close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        return false;
+    }
+
+    /**
+     * Call an IPC method and wait for the response.
+     *
+     * @return The response, or a JSON object with an "error" field if the connection failed.
+     */
+    nlohmann::json call(const std::string& method, nlohmann::json data = nlohmann::json::object())
+    {
+        nlohmann::json message;
+        message["method"] = method;
+        message["data"]   = std::move(data);
+
+        std::string serialized = message.dump();
+        uint32_t len = serialized.size();
+        if (!write_all(&len, sizeof(len)) || !write_all(serialized.data(), serialized.size()))
+        {
+            return {{"error", "Failed to send IPC message"}};
+        }
+
+        if (!read_all(&len, sizeof(len)))
+        {
+            return {{"error", "Failed to read IPC response"}};
+        }
+
+        std::string response(len, '\0');
+        if (!read_all(response.data(), len))
+        {
+            return {{"error", "Failed to read IPC response"}};
+        }
+
+        return nlohmann::json::parse(response, nullptr, false);
+    }
+
+  private:
+    int fd = -1;
+
+    bool write_all(const void *data, size_t size)
+    {
+        auto ptr = (const char*)data;
+        while (size > 0)
+        {
+            ssize_t written = write(fd, ptr, size);
+            if (written <= 0)
+            {
+                return false;
+            }
+
+            ptr  += written;
+            size -= written;
+        }
+
+        return true;
+    }
+
+    bool read_all(void *data, size_t size)
+    {
+        auto ptr = (char*)data;
+        while (size > 0)
+        {
+            ssize_t nread = read(fd, ptr, size);
+            if (nread <= 0)
+            {
+                return false;
+            }
+
+            ptr  += nread;
+            size -= nread;
+        }
+
+        return true;
+    }
+};
+}
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <chrono>
+
+namespace wf
+{
+namespace bench
+{
+/** Run the callback once and return its wall-clock duration in milliseconds. */
+template<class Callback>
+double measure_ms(Callback&& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+    callback();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+}
+}
@@ -0,0 +1,517 @@
+#include "synthetic-clients.hpp"
+
+#include <wayland-client.h>
+#include "xdg-shell-client-protocol.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using clock_type = std::chrono::steady_clock;
+
+namespace wf
+{
+namespace bench
+{
+struct buffer_t
+{
+    wl_buffer *buffer = nullptr;
+    uint32_t *pixels  = nullptr;
+    bool busy = false;
+};
+
+struct window_t
+{
+    synthetic_clients_t::connection_t *connection;
+    int index;
+    bool probe = false;
+
+    wl_surface *surface   = nullptr;
+    xdg_surface *xdg_surf = nullptr;
+    xdg_toplevel *toplevel = nullptr;
+    buffer_t buffers[2];
+
+    bool configured = false;
+    uint32_t frame  = 0;
+
+    wl_callback *frame_callback = nullptr;
+    clock_type::time_point last_frame;
+    bool has_last_frame = false;
+};
+
+struct synthetic_clients_t::connection_t
+{
+    synthetic_clients_t *clients;
+    const client_options_t& options;
+
+    wl_display *display = nullptr;
+    wl_registry *registry = nullptr;
+    wl_compositor *compositor = nullptr;
+    wl_shm *shm = nullptr;
+    xdg_wm_base *wm_base = nullptr;
+
+    std::vector<std::unique_ptr<window_t>> windows;
+    void *shm_data   = nullptr;
+    size_t shm_size  = 0;
+    std::atomic<int> skipped_updates{0};
+
+    connection_t(synthetic_clients_t *clients, const client_options_t& options) :
+        clients(clients), options(options)
+    {}
+
+    ~connection_t();
+
+    bool connect(const std::string& name, int nr_windows, int first_index);
+    bool all_configured() const;
+    void run(std::atomic<bool>& running);
+    void update(window_t& window);
+    void draw(window_t& window, buffer_t& buffer);
+    void request_frame(window_t& window);
+};
+
+/* Listeners */
+
+static void handle_ping(void*, xdg_wm_base *wm_base, uint32_t serial)
+{
+    xdg_wm_base_pong(wm_base, serial);
+}
+
+static const xdg_wm_base_listener wm_base_listener = {
+    .ping = handle_ping,
+};
+
+static void handle_global(void *data, wl_registry *registry, uint32_t name, const char *interface,
+    uint32_t version)
+{
+    auto connection = (synthetic_clients_t::connection_t*)data;
+    if (!std::strcmp(interface, wl_compositor_interface.name))
+    {
+        connection->compositor = (wl_compositor*)wl_registry_bind(registry, name,
+            &wl_compositor_interface, std::min(version, 4u));
+    } else if (!std::strcmp(interface, wl_shm_interface.name))
+    {
+        connection->shm = (wl_shm*)wl_registry_bind(registry, name, &wl_shm_interface, 1);
+    } else if (!std::strcmp(interface, xdg_wm_base_interface.name))
+    {
+        connection->wm_base = (xdg_wm_base*)wl_registry_bind(registry, name, &xdg_wm_base_interface, 1);
+        xdg_wm_base_add_listener(connection->wm_base, &wm_base_listener, nullptr);
+    }
+}
+
+static void handle_global_remove(void*, wl_registry*, uint32_t)
+{}
+
+static const wl_registry_listener registry_listener = {
+    .global = handle_global,
+    .global_remove = handle_global_remove,
+};
+
+static void handle_buffer_release(void *data, wl_buffer*)
+{
+    ((buffer_t*)data)->busy = false;
+}
+
+static const wl_buffer_listener buffer_listener = {
+    .release = handle_buffer_release,
+};
+
+static void handle_xdg_surface_configure(void *data, xdg_surface *xdg_surf, uint32_t serial)
+{
+    auto window = (window_t*)data;
+    xdg_surface_ack_configure(xdg_surf, serial);
+    if (!window->configured)
+    {
+        window->configured = true;
+        if (window->probe)
+        {
+            window->connection->request_frame(*window);
+        }
+
+        window->connection->update(*window);
+    }
+}
+
+static const xdg_surface_listener xdg_surface_listener = {
+    .configure = handle_xdg_surface_configure,
+};
+
+static void handle_toplevel_configure(void*, xdg_toplevel*, int32_t, int32_t, wl_array*)
+{}
+
+static void handle_toplevel_close(void*, xdg_toplevel*)
+{}
+
+static const xdg_toplevel_listener toplevel_listener = {
+    .configure = handle_toplevel_configure,
+    .close     = handle_toplevel_close,
+};
+
+static void handle_frame_done(void *data, wl_callback *callback, uint32_t)
+{
+    auto window = (window_t*)data;
+    wl_callback_destroy(callback);
+    window->frame_callback = nullptr;
+
+    auto now = clock_type::now();
+    if (window->has_last_frame)
+    {
+        window->connection->clients->add_frame_interval(
+            std::chrono::duration<double, std::milli>(now - window->last_frame).count());
+    }
+
+    window->last_frame     = now;
+    window->has_last_frame = true;
+
+    // Keep the frame callbacks coming, even if the window content does not change.
+    window->connection->request_frame(*window);
+    wl_surface_commit(window->surface);
+}
+
+static const wl_callback_listener frame_listener = {
+    .done = handle_frame_done,
+};
+
+/* Connection implementation */
+
+synthetic_clients_t::connection_t::~connection_t()
+{
+    for (auto& window : windows)
+    {
+        if (window->frame_callback)
+        {
+            wl_callback_destroy(window->frame_callback);
+        }
+
+        for (auto& buffer : window->buffers)
+        {
+            if (buffer.buffer)
+            {
+                wl_buffer_destroy(buffer.buffer);
+            }
+        }
+
+        if (window->toplevel)
+        {
+            xdg_toplevel_destroy(window->toplevel);
+        }
+
+        if (window->xdg_surf)
+        {
+            xdg_surface_destroy(window->xdg_surf);
+        }
+
+        if (window->surface)
+        {
+            wl_surface_destroy(window->surface);
+        }
+    }
+
+    if (shm_data)
+    {
+        munmap(shm_data, shm_size);
+    }
+
+    if (display)
+    {
+        wl_display_disconnect(display);
+    }
+}
+
+bool synthetic_clients_t::connection_t::connect(const std::string& name, int nr_windows, int first_index)
+{
+    display = wl_display_connect(name.c_str());
+    if (!display)
+    {
+        std::cerr << "Failed to connect to " << name << std::endl;
+        return false;
+    }
+
+    registry = wl_display_get_registry(display);
+    wl_registry_add_listener(registry, &registry_listener, this);
+    wl_display_roundtrip(display);
+    if (!compositor || !shm || !wm_base)
+    {
+        std::cerr << "The compositor does not support wl_compositor, wl_shm or xdg_wm_base" << std::endl;
+        return false;
+    }
+
+    // One pool for all buffers of the connection.
+    const size_t stride = options.width * 4;
+    const size_t buffer_size = stride * options.height;
+    shm_size = buffer_size * 2 * nr_windows;
+    int fd = memfd_create("wayfire-bench", MFD_CLOEXEC);
+    if ((fd < 0) || (ftruncate(fd, shm_size) < 0))
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+
+        std::cerr << "Failed to allocate shared memory" << std::endl;
+        return false;
+    }
+
+    shm_data = mmap(nullptr, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (shm_data == MAP_FAILED)
+    {
+        shm_data = nullptr;
+        close(fd);
+        std::cerr << "Failed to map shared memory" << std::endl;
+        return false;
+    }
+
+    auto pool = wl_shm_create_pool(shm, fd, shm_size);
+    close(fd);
+
+    for (int i = 0; i < nr_windows; i++)
+    {
+        auto window = std::make_unique<window_t>();
+        window->connection = this;
+        window->index = first_index + i;
+        window->probe = (window->index == 0);
+
+        for (int j = 0; j < 2; j++)
+        {
+            size_t offset = buffer_size * (2 * i + j);
+            auto& buffer  = window->buffers[j];
+            buffer.pixels = (uint32_t*)((char*)shm_data + offset);
+            buffer.buffer = wl_shm_pool_create_buffer(pool, offset, options.width, options.height,
+                stride, WL_SHM_FORMAT_XRGB8888);
+            wl_buffer_add_listener(buffer.buffer, &buffer_listener, &buffer);
+        }
+
+        window->surface  = wl_compositor_create_surface(compositor);
+        window->xdg_surf = xdg_wm_base_get_xdg_surface(wm_base, window->surface);
+        xdg_surface_add_listener(window->xdg_surf, &xdg_surface_listener, window.get());
+        window->toplevel = xdg_surface_get_toplevel(window->xdg_surf);
+        xdg_toplevel_add_listener(window->toplevel, &toplevel_listener, window.get());
+        xdg_toplevel_set_app_id(window->toplevel, "wayfire-bench");
+        xdg_toplevel_set_title(window->toplevel, ("Synthetic client " + std::to_string(window->index)).c_str());
+        wl_surface_commit(window->surface);
+        windows.push_back(std::move(window));
+    }
+
+    wl_shm_pool_destroy(pool);
+    wl_display_flush(display);
+    return true;
+}
+
+bool synthetic_clients_t::connection_t::all_configured() const
+{
+    for (auto& window : windows)
+    {
+        if (!window->configured)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void synthetic_clients_t::connection_t::request_frame(window_t& window)
+{
+    window.frame_callback = wl_surface_frame(window.surface);
+    wl_callback_add_listener(window.frame_callback, &frame_listener, &window);
+}
+
+void synthetic_clients_t::connection_t::draw(window_t& window, buffer_t& buffer)
+{
+    // Each window gets its own color, which changes slightly with each frame.
+    const uint32_t color = 0xff000000 | ((window.index * 0x3f5a7b + window.frame * 0x010101) & 0xffffff);
+    const bool first_frame = (window.frame == 0);
+    if ((options.damage == damage_pattern_t::FULL) || first_frame ||
+        (options.damage == damage_pattern_t::NONE))
+    {
+        std::fill(buffer.pixels, buffer.pixels + options.width * options.height, color);
+        wl_surface_damage_buffer(window.surface, 0, 0, options.width, options.height);
+        return;
+    }
+
+    // A square moving along the diagonal.
+    const int size = std::min({32, options.width, options.height});
+    const int x    = (int)(window.frame * 4 % (uint32_t)(options.width - size + 1));
+    const int y    = (int)(window.frame * 4 % (uint32_t)(options.height - size + 1));
+    for (int row = y; row < y + size; row++)
+    {
+        std::fill(buffer.pixels + row * options.width + x, buffer.pixels + row * options.width + x + size,
+            color);
+    }
+
+    wl_surface_damage_buffer(window.surface, x, y, size, size);
+}
+
+void synthetic_clients_t::connection_t::update(window_t& window)
+{
+    buffer_t *buffer = nullptr;
+    for (auto& b : window.buffers)
+    {
+        if (!b.busy)
+        {
+            buffer = &b;
+            break;
+        }
+    }
+
+    if (!buffer)
+    {
+        skipped_updates++;
+        return;
+    }
+
+    draw(window, *buffer);
+    buffer->busy = true;
+    window.frame++;
+    wl_surface_attach(window.surface, buffer->buffer, 0, 0);
+    wl_surface_commit(window.surface);
+}
+
+void synthetic_clients_t::connection_t::run(std::atomic<bool>& running)
+{
+    const bool updates = (options.damage != damage_pattern_t::NONE) && (options.update_rate > 0);
+    const auto interval = std::chrono::duration_cast<clock_type::duration>(
+        std::chrono::duration<double>(updates ? 1.0 / options.update_rate : 1.0));
+    auto next_update = clock_type::now() + interval;
+
+    while (running)
+    {
+        auto now = clock_type::now();
+        if (updates && (now >= next_update))
+        {
+            for (auto& window : windows)
+            {
+                update(*window);
+            }
+
+            next_update += interval;
+            if (next_update < now)
+            {
+                // We are falling behind, do not try to catch up.
+                next_update = now + interval;
+            }
+        }
+
+        while (wl_display_prepare_read(display) != 0)
+        {
+            wl_display_dispatch_pending(display);
+        }
+
+        wl_display_flush(display);
+        int timeout = 100;
+        if (updates)
+        {
+            auto until_update = std::chrono::duration_cast<std::chrono::milliseconds>(next_update - now);
+            timeout = std::max(0, std::min(timeout, (int)until_update.count()));
+        }
+
+        pollfd fd = {wl_display_get_fd(display), POLLIN, 0};
+        if ((poll(&fd, 1, timeout) > 0) && (fd.revents & POLLIN))
+        {
+            if (wl_display_read_events(display) < 0)
+            {
+                break;
+            }
+        } else
+        {
+            wl_display_cancel_read(display);
+        }
+
+        if (wl_display_dispatch_pending(display) < 0)
+        {
+            break;
+        }
+    }
+}
+
+/* synthetic_clients_t */
+
+synthetic_clients_t::synthetic_clients_t(std::string display, client_options_t options) :
+    display(std::move(display)), options(options)
+{}
+
+synthetic_clients_t::~synthetic_clients_t()
+{
+    stop();
+}
+
+bool synthetic_clients_t::start(int timeout_ms)
+{
+    const int nr_connections = std::max(1, std::min(options.connections, options.windows));
+    int first_index = 0;
+    for (int i = 0; i < nr_connections; i++)
+    {
+        int nr_windows = options.windows / nr_connections + (i < options.windows % nr_connections);
+        auto connection = std::make_unique<connection_t>(this, options);
+        if (!connection->connect(display, nr_windows, first_index))
+        {
+            return false;
+        }
+
+        first_index += nr_windows;
+        connections.push_back(std::move(connection));
+    }
+
+    auto deadline = clock_type::now() + std::chrono::milliseconds(timeout_ms);
+    for (auto& connection : connections)
+    {
+        while (!connection->all_configured())
+        {
+            if ((clock_type::now() > deadline) || (wl_display_roundtrip(connection->display) < 0))
+            {
+                std::cerr << "Timed out waiting for the windows to be mapped" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    running = true;
+    for (auto& connection : connections)
+    {
+        threads.emplace_back([this, conn = connection.get()] () { conn->run(running); });
+    }
+
+    return true;
+}
+
+void synthetic_clients_t::stop()
+{
+    running = false;
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    threads.clear();
+    connections.clear();
+}
+
+void synthetic_clients_t::add_frame_interval(double ms)
+{
+    std::lock_guard<std::mutex> lock(intervals_mutex);
+    frame_intervals.push_back(ms);
+}
+
+std::vector<double> synthetic_clients_t::take_frame_intervals()
+{
+    std::lock_guard<std::mutex> lock(intervals_mutex);
+    auto result = std::move(frame_intervals);
+    frame_intervals.clear();
+    return result;
+}
+
+int synthetic_clients_t::get_skipped_updates() const
+{
+    int skipped = 0;
+    for (auto& connection : connections)
+    {
+        skipped += connection->skipped_updates;
+    }
+
+    return skipped;
+}
+}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace wf
+{
+namespace bench
+{
+/** Which part of a window is redrawn on each update. */
+enum class damage_pattern_t
+{
+    /** The window is drawn once and never updated. */
+    NONE,
+    /** A small square moving across the window. */
+    PARTIAL,
+    /** The whole window. */
+    FULL,
+};
+
+struct client_options_t
+{
+    /** The total number of windows. */
+    int windows = 20;
+    /** The number of Wayland connections the windows are distributed over, each served by a thread. */
+    int connections = 4;
+    int width  = 400;
+    int height = 300;
+    /** How many times per second each window is updated. */
+    double update_rate = 30;
+    damage_pattern_t damage = damage_pattern_t::PARTIAL;
+};
+
+/**
+ * A set of synthetic wl_shm clients with xdg-shell toplevels.
+ *
+ * The first window of the first connection is a probe: it requests a frame callback on every frame, and
+ * the intervals between the callbacks are recorded, which shows how evenly the compositor delivers frames.
+ */
+class synthetic_clients_t
+{
+  public:
+    synthetic_clients_t(std::string display, client_options_t options);
+    ~synthetic_clients_t();
+
+    /**
+     * Connect to the compositor and map all windows.
+     *
+     * @return Whether all windows were mapped before the timeout.
+     */
+    bool start(int timeout_ms);
+
+    /** Stop updating the windows and disconnect. */
+    void stop();
+
+    /** Get and reset the frame callback intervals of the probe window, in milliseconds. */
+    std::vector<double> take_frame_intervals();
+
+    /** The number of window updates skipped because the compositor still held both buffers. */
+    int get_skipped_updates() const;
+
+    /** Record an interval between two frame callbacks of the probe window. */
+    void add_frame_interval(double ms);
+
+    struct connection_t;
+
+  private:
+    std::string display;
+    client_options_t options;
+    std::vector<std::unique_ptr<connection_t>> connections;
+    std::vector<std::thread> threads;
+    std::atomic<bool> running{false};
+
+    std::mutex intervals_mutex;
+    std::vector<double> frame_intervals;
+};
+}
+}
@@ -0,0 +1,616 @@
+#include "ipc-client.hpp"
+#include "synthetic-clients.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <getopt.h>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/**
+ * wayfire-bench starts Wayfire on the headless backend, maps synthetic wl_shm clients, and drives plugins
+ * over IPC, one Wayfire instance per scenario. For each scenario it reports percentiles of:
+ *
+ * - frame-time-ms: the time Wayfire spent painting each batch of outputs, taken from Wayfire's trace;
+ * - frame-interval-ms: the intervals between the frame callbacks received by a probe window;
+ * - cpu-percent: the CPU usage of the Wayfire process, sampled every 100ms.
+ */
+
+using namespace std::chrono_literals;
+using clock_type = std::chrono::steady_clock;
+
+namespace
+{
+struct options_t
+{
+    std::string wayfire = "wayfire";
+    std::string config_backend;
+    wf::bench::client_options_t clients;
+    int outputs  = 1;
+    double duration = 5;
+    double warmup   = 1;
+    std::vector<std::string> scenarios = {"idle", "scale", "expo", "move", "vswitch"};
+    std::string output_file;
+    std::string renderer;
+};
+
+void print_help()
+{
+    std::cout << "Usage: wayfire-bench [OPTION]...\n\n"
+              << " --wayfire PATH          the Wayfire executable to benchmark\n"
+              << " --config-backend PATH   the configuration backend passed to Wayfire\n"
+              << " --windows N             the number of synthetic windows (default 20)\n"
+              << " --connections N         the number of client connections (default 4)\n"
+              << " --size WxH              the size of each window (default 400x300)\n"
+              << " --rate HZ               how often each window is updated (default 30)\n"
+              << " --damage PATTERN        none, partial or full (default partial)\n"
+              << " --outputs N             the number of headless outputs (default 1)\n"
+              << " --duration SECONDS      how long each scenario runs (default 5)\n"
+              << " --scenarios LIST        comma-separated, from idle,scale,expo,move,vswitch\n"
+              << " --renderer NAME         sets WLR_RENDERER for Wayfire\n"
+              << " --output FILE           write the JSON report to FILE instead of stdout\n";
+}
+
+std::vector<std::string> split(const std::string& str, char delim)
+{
+    std::vector<std::string> result;
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, delim))
+    {
+        if (!item.empty())
+        {
+            result.push_back(item);
+        }
+    }
+
+    return result;
+}
+
+bool parse_options(int argc, char **argv, options_t& options)
+{
+    static const option long_options[] = {
+        {"wayfire", required_argument, NULL, 'w'},
+        {"config-backend", required_argument, NULL, 'B'},
+        {"windows", required_argument, NULL, 'n'},
+        {"connections", required_argument, NULL, 'c'},
+        {"size", required_argument, NULL, 's'},
+        {"rate", required_argument, NULL, 'r'},
+        {"damage", required_argument, NULL, 'd'},
+        {"outputs", required_argument, NULL, 'O'},
+        {"duration", required_argument, NULL, 't'},
+        {"scenarios", required_argument, NULL, 'S'},
+        {"renderer", required_argument, NULL, 'R'},
+        {"output", required_argument, NULL, 'o'},
+        {"help", no_argument, NULL, 'h'},
+        {0, 0, NULL, 0}
+    };
+
+    int c, i;
+    while ((c = getopt_long(argc, argv, "h", long_options, &i)) != -1)
+    {
+        switch (c)
+        {
+          case 'w':
+            options.wayfire = optarg;
+            break;
+
+          case 'B':
+            options.config_backend = optarg;
+            break;
+
+          case 'n':
+            options.clients.windows = std::max(1, atoi(optarg));
+            break;
+
+          case 'c':
+            options.clients.connections = std::max(1, atoi(optarg));
+            break;
+
+          case 's':
+            if (sscanf(optarg, "%dx%d", &options.clients.width, &options.clients.height) != 2 ||
+                (options.clients.width <= 0) || (options.clients.height <= 0))
+            {
+                std::cerr << "Invalid size " << optarg << std::endl;
+                return false;
+            }
+
+            break;
+
+          case 'r':
+            options.clients.update_rate = atof(optarg);
+            break;
+
+          case 'd':
+            if (std::string(optarg) == "none")
+            {
+                options.clients.damage = wf::bench::damage_pattern_t::NONE;
+            } else if (std::string(optarg) == "partial")
+            {
+                options.clients.damage = wf::bench::damage_pattern_t::PARTIAL;
+            } else if (std::string(optarg) == "full")
+            {
+                options.clients.damage = wf::bench::damage_pattern_t::FULL;
+            } else
+            {
+                std::cerr << "Invalid damage pattern " << optarg << std::endl;
+                return false;
+            }
+
+            break;
+
+          case 'O':
+            options.outputs = std::max(1, atoi(optarg));
+            break;
+
+          case 't':
+            options.duration = std::max(0.5, atof(optarg));
+            break;
+
+          case 'S':
+            options.scenarios = split(optarg, ',');
+            break;
+
+          case 'R':
+            options.renderer = optarg;
+            break;
+
+          case 'o':
+            options.output_file = optarg;
+            break;
+
+          case 'h':
+          default:
+            print_help();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+nlohmann::json percentiles(std::vector<double> values)
+{
+    nlohmann::json result;
+    result["count"] = values.size();
+    if (values.empty())
+    {
+        return result;
+    }
+
+    std::sort(values.begin(), values.end());
+    auto at = [&] (double p)
+    {
+        return values[std::min(values.size() - 1, (size_t)(p * values.size()))];
+    };
+
+    result["p50"] = at(0.5);
+    result["p90"] = at(0.9);
+    result["p99"] = at(0.99);
+    result["max"] = values.back();
+    return result;
+}
+
+/**
+ * A Wayfire instance running on the headless backend, with its own configuration, sockets and trace file.
+ */
+class wayfire_instance_t
+{
+  public:
+    pid_t pid = -1;
+    std::string dir;
+    std::string ipc_socket;
+    std::string trace_file;
+
+    bool start(const options_t& options)
+    {
+        char tmpl[] = "/tmp/wayfire-bench-XXXXXX";
+        if (!mkdtemp(tmpl))
+        {
+            std::cerr << "Failed to create a temporary directory" << std::endl;
+            return false;
+        }
+
+        dir = tmpl;
+        ipc_socket = dir + "/ipc.socket";
+        trace_file = dir + "/trace.json";
+
+        std::ofstream config(dir + "/wayfire.ini");
+        config << "[core]\n"
+               << "plugins = ipc ipc-rules stipc move scale expo vswitch\n"
+               << "vwidth = 3\n"
+               << "vheight = 3\n"
+               << "xwayland = false\n"
+               << "[move]\n"
+               << "activate = <super> BTN_LEFT\n";
+        config.close();
+
+        pid = fork();
+        if (pid < 0)
+        {
+            std::cerr << "Failed to fork" << std::endl;
+            return false;
+        }
+
+        if (pid == 0)
+        {
+            setenv("WLR_BACKENDS", "headless", 1);
+            setenv("WLR_LIBINPUT_NO_DEVICES", "1", 1);
+            setenv("WLR_HEADLESS_OUTPUTS", std::to_string(options.outputs).c_str(), 1);
+            setenv("XDG_RUNTIME_DIR", dir.c_str(), 1);
+            setenv("_WAYFIRE_SOCKET", ipc_socket.c_str(), 1);
+            if (!options.renderer.empty())
+            {
+                setenv("WLR_RENDERER", options.renderer.c_str(), 1);
+            }
+
+            std::vector<std::string> args = {options.wayfire, "-c", dir + "/wayfire.ini", "-t", trace_file};
+            if (!options.config_backend.empty())
+            {
+                args.push_back("-B");
+                args.push_back(options.config_backend);
+            }
+
+            std::vector<char*> argv;
+            for (auto& arg : args)
+            {
+                argv.push_back(arg.data());
+            }
+
+            argv.push_back(nullptr);
+
+            // Keep the report readable, Wayfire's log goes to a file.
+            freopen((dir + "/wayfire.log").c_str(), "w", stdout);
+            freopen((dir + "/wayfire.log").c_str(), "a", stderr);
+            execvp(argv[0], argv.data());
+            _exit(127);
+        }
+
+        return true;
+    }
+
+    void stop()
+    {
+        if (pid > 0)
+        {
+            kill(pid, SIGTERM);
+            auto deadline = clock_type::now() + 5s;
+            int status;
+            while (waitpid(pid, &status, WNOHANG) == 0)
+            {
+                if (clock_type::now() > deadline)
+                {
+                    kill(pid, SIGKILL);
+                    waitpid(pid, &status, 0);
+                    break;
+                }
+
+                std::this_thread::sleep_for(10ms);
+            }
+
+            pid = -1;
+        }
+    }
+
+    /**
+     * Remove the temporary directory with the configuration, log and trace. Only done after successful
+     * runs, so that the log of a failed run can still be inspected.
+     */
+    void remove_dir()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(dir, ec);
+    }
+
+    bool is_running()
+    {
+        int status;
+        return (pid > 0) && (waitpid(pid, &status, WNOHANG) == 0);
+    }
+
+    /** Get the CPU time used by Wayfire so far, in seconds. */
+    double get_cpu_time()
+    {
+        std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+        std::string content((std::istreambuf_iterator<char>(stat)), std::istreambuf_iterator<char>());
+
+        // Skip the command name, which may contain spaces, then utime and stime are fields 14 and 15.
+        auto fields = split(content.substr(content.rfind(')') + 2), ' ');
+        if (fields.size() < 13)
+        {
+            return 0;
+        }
+
+        return (std::stod(fields[11]) + std::stod(fields[12])) / sysconf(_SC_CLK_TCK);
+    }
+
+    /**
+     * Read the durations of the painted frames from the trace, in milliseconds, skipping frames which
+     * started before @since or after @until.
+     *
+     * Trace timestamps are relative to the start of the trace in Wayfire. The "trace start" event carries
+     * that time on the steady clock, which is shared with this process.
+     */
+    std::vector<double> get_frame_times(clock_type::time_point since, clock_type::time_point until)
+    {
+        static_assert(std::is_same_v<clock_type, std::chrono::steady_clock>,
+            "The trace origin is given on the steady clock");
+        auto to_us = [] (clock_type::time_point time)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+        };
+
+        std::optional<int64_t> origin;
+        std::vector<double> result;
+        std::ifstream trace(trace_file);
+        std::string line;
+        while (std::getline(trace, line))
+        {
+            if (!origin)
+            {
+                auto origin_field = line.find("\"steady_clock_us\":");
+                if ((line.find("\"name\":\"trace start\"") != std::string::npos) &&
+                    (origin_field != std::string::npos))
+                {
+                    origin = std::stoll(line.substr(origin_field + 18));
+                }
+
+                continue;
+            }
+
+            if (line.find("\"name\":\"paint outputs\"") == std::string::npos)
+            {
+                continue;
+            }
+
+            auto ts  = line.find("\"ts\":");
+            auto dur = line.find("\"dur\":");
+            if ((ts == std::string::npos) || (dur == std::string::npos))
+            {
+                continue;
+            }
+
+            const int64_t frame_ts = *origin + std::stoll(line.substr(ts + 5));
+            if ((frame_ts >= to_us(since)) && (frame_ts <= to_us(until)))
+            {
+                result.push_back(std::stoll(line.substr(dur + 6)) / 1000.0);
+            }
+        }
+
+        return result;
+    }
+};
+
+/**
+ * Drives a plugin during a scenario. step() is called every 100ms.
+ */
+class scenario_driver_t
+{
+  public:
+    scenario_driver_t(const std::string& name, wf::bench::ipc_client_t& ipc) : name(name), ipc(ipc)
+    {
+        auto outputs = ipc.call("window-rules/list-outputs");
+        if (outputs.is_array() && !outputs.empty())
+        {
+            output_id = outputs[0]["id"];
+            geometry  = outputs[0]["geometry"];
+        }
+    }
+
+    bool is_valid() const
+    {
+        static const std::vector<std::string> known = {"idle", "scale", "expo", "move", "vswitch"};
+        return std::find(known.begin(), known.end(), name) != known.end();
+    }
+
+    void step(int tick)
+    {
+        if (name == "scale")
+        {
+            // Toggle every second.
+            if (tick % 10 == 0)
+            {
+                check(ipc.call("scale/toggle", {{"output_id", output_id}}));
+            }
+        } else if (name == "expo")
+        {
+            if (tick % 10 == 0)
+            {
+                check(ipc.call("expo/toggle", {{"output_id", output_id}}));
+            }
+        } else if (name == "vswitch")
+        {
+            // Go around the 3x3 workspace grid.
+            if (tick % 5 == 0)
+            {
+                int ws = (tick / 5) % 9;
+                check(ipc.call("vswitch/set-workspace",
+                    {{"x", ws % 3}, {"y", ws / 3}, {"output-id", output_id}}));
+            }
+        } else if (name == "move")
+        {
+            move_step(tick);
+        }
+    }
+
+    void finish()
+    {
+        if (name == "move")
+        {
+            ipc.call("stipc/feed_button", {{"combo", "S-BTN_LEFT"}, {"mode", "release"}});
+        }
+    }
+
+    int errors = 0;
+
+  private:
+    std::string name;
+    wf::bench::ipc_client_t& ipc;
+    int output_id = 0;
+    nlohmann::json geometry = {{"x", 0}, {"y", 0}, {"width", 1280}, {"height", 720}};
+
+    void check(const nlohmann::json& response)
+    {
+        if (response.is_discarded() || response.contains("error"))
+        {
+            if (errors++ == 0)
+            {
+                std::cerr << "Scenario " << name << ": " << response.dump() << std::endl;
+            }
+        }
+    }
+
+    void move_step(int tick)
+    {
+        const double cx = (double)geometry["x"] + (double)geometry["width"] / 2;
+        const double cy = (double)geometry["y"] + (double)geometry["height"] / 2;
+        if (tick == 0)
+        {
+            // Grab the topmost window, which is placed around the center.
+            check(ipc.call("stipc/move_cursor", {{"x", cx}, {"y", cy}}));
+            check(ipc.call("stipc/feed_button", {{"combo", "S-BTN_LEFT"}, {"mode", "press"}}));
+            return;
+        }
+
+        // Move it around in a circle.
+        const double angle = tick * 0.2;
+        const double radius = std::min((double)geometry["width"], (double)geometry["height"]) / 4;
+        check(ipc.call("stipc/move_cursor",
+            {{"x", cx + radius * std::cos(angle)}, {"y", cy + radius * std::sin(angle)}}));
+    }
+};
+
+nlohmann::json run_scenario(const options_t& options, const std::string& scenario)
+{
+    nlohmann::json result;
+    wayfire_instance_t wayfire;
+    if (!wayfire.start(options))
+    {
+        result["error"] = "Failed to start Wayfire";
+        return result;
+    }
+
+    wf::bench::ipc_client_t ipc;
+    if (!ipc.connect(wayfire.ipc_socket, 10s))
+    {
+        wayfire.stop();
+        result["error"] = "Failed to connect to Wayfire, see " + wayfire.dir + "/wayfire.log";
+        return result;
+    }
+
+    auto display = ipc.call("stipc/get_display");
+    std::string wayland_display = display.value("wayland", "");
+    setenv("XDG_RUNTIME_DIR", wayfire.dir.c_str(), 1);
+
+    wf::bench::synthetic_clients_t clients{wayland_display, options.clients};
+    if (!clients.start(10000))
+    {
+        wayfire.stop();
+        result["error"] = "Failed to map the synthetic clients";
+        return result;
+    }
+
+    scenario_driver_t driver{scenario, ipc};
+    if (!driver.is_valid())
+    {
+        clients.stop();
+        wayfire.stop();
+        result["error"] = "Unknown scenario " + scenario;
+        return result;
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.warmup));
+    clients.take_frame_intervals();
+
+    auto start = clock_type::now();
+    auto end   = start + std::chrono::duration_cast<clock_type::duration>(
+        std::chrono::duration<double>(options.duration));
+
+    std::vector<double> cpu_samples;
+    double last_cpu  = wayfire.get_cpu_time();
+    auto last_sample = clock_type::now();
+    for (int tick = 0; clock_type::now() < end; tick++)
+    {
+        driver.step(tick);
+        std::this_thread::sleep_until(start + tick * 100ms + 100ms);
+        if (!wayfire.is_running())
+        {
+            result["error"] = "Wayfire exited during the scenario, see " + wayfire.dir + "/wayfire.log";
+            clients.stop();
+            return result;
+        }
+
+        auto now = clock_type::now();
+        double cpu = wayfire.get_cpu_time();
+        double wall = std::chrono::duration<double>(now - last_sample).count();
+        cpu_samples.push_back(100.0 * (cpu - last_cpu) / wall);
+        last_cpu    = cpu;
+        last_sample = now;
+    }
+
+    driver.finish();
+    auto frame_intervals = clients.take_frame_intervals();
+    result["skipped-client-updates"] = clients.get_skipped_updates();
+    result["ipc-errors"] = driver.errors;
+    clients.stop();
+    wayfire.stop();
+
+    result["frame-time-ms"]     = percentiles(wayfire.get_frame_times(start, end));
+    result["frame-interval-ms"] = percentiles(frame_intervals);
+    result["cpu-percent"] = percentiles(cpu_samples);
+    wayfire.remove_dir();
+    return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+    options_t options;
+    if (!parse_options(argc, argv, options))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // A synthetic client may be disconnected while Wayfire shuts down.
+    signal(SIGPIPE, SIG_IGN);
+
+    nlohmann::json report;
+    report["windows"]     = options.clients.windows;
+    report["connections"] = options.clients.connections;
+    report["window-size"] = {options.clients.width, options.clients.height};
+    report["update-rate"] = options.clients.update_rate;
+    report["outputs"]     = options.outputs;
+    report["duration"]    = options.duration;
+
+    bool failed = false;
+    for (auto& scenario : options.scenarios)
+    {
+        std::cerr << "Running scenario " << scenario << std::endl;
+        report["scenarios"][scenario] = run_scenario(options, scenario);
+        failed |= report["scenarios"][scenario].contains("error");
+    }
+
+    if (options.output_file.empty())
+    {
+        std::cout << report.dump(2) << std::endl;
+    } else
+    {
+        std::ofstream(options.output_file) << report.dump(2) << std::endl;
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,124 @@
+#include <wayfire/img.hpp>
+#include <wayfire/util/log.hpp>
+#include <wayland-server-core.h>
+#include "../../src/core/worker-pool.hpp"
+#include "../bench/measure.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Decode a set of generated wallpaper-sized images in three ways:
+ * - sequentially on the calling thread, like image_io::load_from_file() used to do,
+ * - a second time, which should be served from the decoded image cache,
+ * - in parallel on a worker pool, like image_io::decode_file_async() does.
+ */
+
+static constexpr int NR_IMAGES = 8;
+static constexpr int IMAGE_WIDTH  = 1920;
+static constexpr int IMAGE_HEIGHT = 1080;
+
+static std::vector<std::string> generate_images(const std::string& dir, const std::string& prefix)
+{
+    std::vector<uint8_t> pixels(IMAGE_WIDTH * IMAGE_HEIGHT * 4);
+    std::vector<std::string> names;
+    for (int n = 0; n < NR_IMAGES; n++)
+    {
+        // A noisy gradient, so that the images do not compress to almost nothing.
+        uint32_t seed = 12345 + n;
+        for (int i = 0; i < IMAGE_HEIGHT; i++)
+        {
+            for (int j = 0; j < IMAGE_WIDTH; j++)
+            {
+                seed = seed * 1103515245 + 12345;
+                uint8_t *px = &pixels[(i * IMAGE_WIDTH + j) * 4];
+                px[0] = (j * 255 / IMAGE_WIDTH) ^ (seed >> 28);
+                px[1] = (i * 255 / IMAGE_HEIGHT) ^ ((seed >> 24) & 0xf);
+                px[2] = n * 31;
+                px[3] = 255;
+            }
+        }
+
+        names.push_back(dir + "/" + prefix + std::to_string(n) + ".png");
+        image_io::write_to_file(names.back(), pixels.data(), IMAGE_WIDTH, IMAGE_HEIGHT, "png");
+    }
+
+    return names;
+}
+
+static void report(const std::string& name, double ms)
+{
+    std::cout << name << ": " << ms << " ms total, " << ms / NR_IMAGES << " ms per image" << std::endl;
+}
+
+int main()
+{
+    wf::log::initialize_logging(std::cout, wf::log::LOG_LEVEL_ERROR, wf::log::LOG_COLOR_MODE_OFF);
+    image_io::init();
+
+    char dir_template[] = "/tmp/wayfire-image-bench-XXXXXX";
+    if (!mkdtemp(dir_template))
+    {
+        std::cerr << "Failed to create a temporary directory" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::string dir = dir_template;
+    auto sequential_set = generate_images(dir, "sequential-");
+    auto parallel_set   = generate_images(dir, "parallel-");
+
+    int failed = 0;
+    report("Sequential decoding", wf::bench::measure_ms([&] ()
+    {
+        for (auto& name : sequential_set)
+        {
+            failed += !image_io::decode_file(name);
+        }
+    }));
+
+    report("Cached decoding", wf::bench::measure_ms([&] ()
+    {
+        for (auto& name : sequential_set)
+        {
+            failed += !image_io::decode_file(name);
+        }
+    }));
+
+    auto loop = wl_event_loop_create();
+    {
+        wf::worker_pool_t pool{loop, 4};
+        report("Parallel decoding (4 threads)", wf::bench::measure_ms([&] ()
+        {
+            int remaining = NR_IMAGES;
+            for (auto& name : parallel_set)
+            {
+                auto result = std::make_shared<bool>(false);
+                pool.submit([name, result] { *result = (bool)image_io::decode_file(name); },
+                    [&, result] ()
+                {
+                    failed += !*result;
+                    --remaining;
+                });
+            }
+
+            while (remaining > 0)
+            {
+                wl_event_loop_dispatch(loop, -1);
+            }
+        }));
+    }
+
+    wl_event_loop_destroy(loop);
+    std::filesystem::remove_all(dir);
+
+    if (failed)
+    {
+        std::cerr << failed << " images failed to decode" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,103 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <wayfire/img.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static constexpr int WIDTH  = 67;
+static constexpr int HEIGHT = 13;
+
+/**
+ * A small framebuffer which exercises every QOI operation: runs (longer than the maximal run of 62),
+ * repeated colors, small and large differences and changes of alpha.
+ */
+static std::vector<uint8_t> generate_pixels()
+{
+    std::vector<uint8_t> pixels(WIDTH * HEIGHT * 4);
+    uint32_t seed = 42;
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        for (int j = 0; j < WIDTH; j++)
+        {
+            seed = seed * 1103515245 + 12345;
+            uint8_t *px = &pixels[(i * WIDTH + j) * 4];
+            if (i < 2)
+            {
+                px[0] = px[1] = px[2] = 0;
+                px[3] = 255;
+            } else if (i < 5)
+            {
+                px[0] = j;
+                px[1] = 2 * j;
+                px[2] = 255 - j;
+                px[3] = 255;
+            } else if (i < 8)
+            {
+                px[0] = (j % 3) * 100;
+                px[1] = (j % 3) * 50;
+                px[2] = 7;
+                px[3] = (j % 2) ? 255 : 128;
+            } else
+            {
+                px[0] = seed >> 24;
+                px[1] = seed >> 16;
+                px[2] = seed >> 8;
+                px[3] = (i == HEIGHT - 1) ? seed : 255;
+            }
+        }
+    }
+
+    return pixels;
+}
+
+static void write_and_decode(const std::vector<uint8_t>& pixels, bool invert,
+    std::vector<uint8_t>& decoded)
+{
+    char dir_template[] = "/tmp/wayfire-qoi-test-XXXXXX";
+    REQUIRE(mkdtemp(dir_template));
+    std::string dir  = dir_template;
+    std::string name = dir + (invert ? "/inverted.qoi" : "/image.qoi");
+
+    image_io::write_to_file(name, (uint8_t*)pixels.data(), WIDTH, HEIGHT, "qoi", invert);
+    auto image = image_io::decode_file(name);
+    std::filesystem::remove_all(dir);
+
+    REQUIRE(image);
+    CHECK(image->width == WIDTH);
+    CHECK(image->height == HEIGHT);
+    CHECK(image->channels == 4);
+    decoded = image->pixels;
+}
+
+TEST_CASE("QOI images survive a round trip")
+{
+    image_io::init();
+    auto pixels = generate_pixels();
+
+    std::vector<uint8_t> decoded;
+    write_and_decode(pixels, false, decoded);
+    CHECK(decoded == pixels);
+    image_io::fini();
+}
+
+TEST_CASE("Inverted QOI images are flipped vertically")
+{
+    image_io::init();
+    auto pixels = generate_pixels();
+
+    std::vector<uint8_t> decoded;
+    write_and_decode(pixels, true, decoded);
+    REQUIRE(decoded.size() == pixels.size());
+    for (int i = 0; i < HEIGHT; i++)
+    {
+        auto row     = pixels.begin() + i * WIDTH * 4;
+        auto flipped = decoded.begin() + (HEIGHT - i - 1) * WIDTH * 4;
+        CHECK(std::equal(row, row + WIDTH * 4, flipped));
+    }
+
+    image_io::fini();
+}
@@ -0,0 +1,93 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <wayfire/gpu-resources.hpp>
+
+#include <algorithm>
+#include <optional>
+
+using namespace wf::gpu_resources;
+
+static std::optional<resource_t> find(resource_type_t type, GLuint id)
+{
+    auto resources = get_resources();
+    auto it = std::find_if(resources.begin(), resources.end(), [&] (const resource_t& res)
+    {
+        return (res.type == type) && (res.id == id);
+    });
+
+    if (it == resources.end())
+    {
+        return {};
+    }
+
+    return *it;
+}
+
+static void allocating_function()
+{}
+
+TEST_CASE("Textures are tracked, resized and untracked")
+{
+    const void *caller = (const void*)&allocating_function;
+    track_texture(1, 100, 50, caller);
+
+    auto tex = find(resource_type_t::TEXTURE, 1);
+    REQUIRE(tex.has_value());
+    CHECK(tex->width == 100);
+    CHECK(tex->height == 50);
+    CHECK(tex->bytes == 100 * 50 * 4);
+    // Attributed to this test executable
+    CHECK(!tex->owner.empty());
+    CHECK(tex->owner != "unknown");
+    CHECK(tex->owner.find('/') == std::string::npos);
+
+    auto owner = tex->owner;
+    track_texture(1, 20, 10, nullptr);
+    tex = find(resource_type_t::TEXTURE, 1);
+    REQUIRE(tex.has_value());
+    CHECK(tex->bytes == 20 * 10 * 4);
+    CHECK(tex->owner == owner);
+
+    untrack_texture(1);
+    CHECK(!find(resource_type_t::TEXTURE, 1).has_value());
+    CHECK(get_resources().empty());
+
+    // Untracking an unknown resource is a no-op
+    untrack_texture(1);
+    CHECK(get_resources().empty());
+}
+
+TEST_CASE("Textures and framebuffers with the same id are tracked separately")
+{
+    track_texture(7, 10, 10, nullptr);
+    track_framebuffer(7, nullptr);
+    CHECK(get_resources().size() == 2);
+
+    auto fb = find(resource_type_t::FRAMEBUFFER, 7);
+    REQUIRE(fb.has_value());
+    CHECK(fb->bytes == 0);
+    CHECK(fb->owner == "unknown");
+
+    untrack_framebuffer(7);
+    CHECK(!find(resource_type_t::FRAMEBUFFER, 7).has_value());
+    CHECK(find(resource_type_t::TEXTURE, 7).has_value());
+    untrack_texture(7);
+    CHECK(get_resources().empty());
+}
+
+TEST_CASE("Resources can be handed to another owner")
+{
+    track_framebuffer(3, nullptr);
+    set_owner(resource_type_t::FRAMEBUFFER, 3, (const void*)&allocating_function);
+
+    auto fb = find(resource_type_t::FRAMEBUFFER, 3);
+    REQUIRE(fb.has_value());
+    CHECK(fb->owner != "unknown");
+
+    // Not tracked, so nothing happens
+    set_owner(resource_type_t::TEXTURE, 3, (const void*)&allocating_function);
+    CHECK(!find(resource_type_t::TEXTURE, 3).has_value());
+
+    untrack_framebuffer(3);
+    CHECK(get_resources().empty());
+}
@@ -54,3 +54,23 @@ TEST_CASE("Misc factory works")
     REQUIRE(destruct_events == 1);
     REQUIRE(allocator.get_all().size() == 1);
 }
+
+class object_t : public wf::object_base_t
+{};
+
+TEST_CASE("Objects can be found by id")
+{
+    auto& allocator = wf::tracking_allocator_t<object_t>::get();
+    auto obj_a = allocator.allocate<object_t>();
+    REQUIRE(allocator.find_by_id(obj_a->get_id()).get() == obj_a.get());
+
+    uint32_t id_b;
+    {
+        auto obj_b = allocator.allocate<object_t>();
+        id_b = obj_b->get_id();
+        REQUIRE(allocator.find_by_id(id_b).get() == obj_b.get());
+    }
+
+    REQUIRE(allocator.find_by_id(id_b) == nullptr);
+    REQUIRE(allocator.find_by_id(obj_a->get_id()).get() == obj_a.get());
+}
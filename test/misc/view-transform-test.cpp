@@ -0,0 +1,154 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <wayfire/view-transform.hpp>
+
+using namespace wf::scene;
+
+class texture_node_t : public node_t, public zero_copy_texturable_node_t
+{
+  public:
+    texture_node_t() : node_t(false)
+    {}
+
+    std::optional<wf::texture_t> to_texture() const override
+    {
+        return wf::texture_t{42};
+    }
+
+    wf::geometry_t get_bounding_box() override
+    {
+        return {0, 0, 100, 100};
+    }
+};
+
+/** A 2D transformer with custom rendering, which must not be skipped. */
+class custom_2d_transformer_t : public wf::scene::view_2d_transformer_t
+{
+  public:
+    custom_2d_transformer_t() : view_2d_transformer_t(nullptr)
+    {}
+
+    class render_instance_t : public transformer_render_instance_t<custom_2d_transformer_t>
+    {
+      public:
+        using transformer_render_instance_t::transformer_render_instance_t;
+        void render(const wf::render_target_t& target, const wf::region_t& region) override
+        {}
+    };
+
+    void gen_render_instances(std::vector<render_instance_uptr>& instances,
+        damage_callback push_damage, wf::output_t *shown_on) override
+    {
+        instances.push_back(std::make_unique<render_instance_t>(this, push_damage, shown_on));
+    }
+};
+
+class outer_transformer_t : public transformer_base_node_t
+{
+  public:
+    outer_transformer_t() : transformer_base_node_t(false)
+    {}
+
+    class render_instance_t : public transformer_render_instance_t<outer_transformer_t>
+    {
+      public:
+        using transformer_render_instance_t::transformer_render_instance_t;
+        using transformer_render_instance_t::fused_texture;
+        void render(const wf::render_target_t& target, const wf::region_t& region) override
+        {}
+    };
+};
+
+static std::shared_ptr<outer_transformer_t> wrap(std::shared_ptr<transformer_base_node_t> middle)
+{
+    middle->set_children_list({std::make_shared<texture_node_t>()});
+    auto outer = std::make_shared<outer_transformer_t>();
+    outer->set_children_list({middle});
+    return outer;
+}
+
+TEST_CASE("Plain 2D transformers are fused")
+{
+    auto middle = std::make_shared<view_2d_transformer_t>(nullptr);
+    middle->alpha = 0.5;
+    auto outer = wrap(middle);
+
+    outer_transformer_t::render_instance_t instance{outer.get(), [] (auto) {}, nullptr};
+    auto fused = instance.fused_texture();
+    REQUIRE(fused.has_value());
+    CHECK(fused->texture.tex_id == 42);
+    CHECK(fused->alpha == doctest::Approx(0.5));
+    CHECK(fused->geometry == wf::geometry_t{0, 0, 100, 100});
+}
+
+TEST_CASE("Subclasses of 2D transformers are not fused")
+{
+    auto middle = std::make_shared<custom_2d_transformer_t>();
+    CHECK(!middle->can_fuse());
+    auto outer = wrap(middle);
+
+    outer_transformer_t::render_instance_t instance{outer.get(), [] (auto) {}, nullptr};
+    CHECK(!instance.fused_texture().has_value());
+}
+
+static void check_transform(const glm::mat4& transform, const std::vector<view_2d_transformer_t*>& chain)
+{
+    // The corners of the texture, and a point inside it
+    const std::vector<wf::pointf_t> points = {{0, 0}, {100, 0}, {0, 100}, {100, 100}, {30, 70}};
+    for (auto point : points)
+    {
+        auto expected = point;
+        for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+        {
+            expected = (*it)->to_global(expected);
+        }
+
+        auto actual = transform * glm::vec4(point.x, point.y, 0.0, 1.0);
+        CHECK(actual.x == doctest::Approx(expected.x).epsilon(1e-4));
+        CHECK(actual.y == doctest::Approx(expected.y).epsilon(1e-4));
+    }
+}
+
+TEST_CASE("The fused transform matches to_global()")
+{
+    auto middle = std::make_shared<view_2d_transformer_t>(nullptr);
+    middle->translation_x = 40;
+    middle->translation_y = -25;
+    middle->scale_x = 0.5;
+    middle->scale_y = 2.0;
+    auto outer = wrap(middle);
+
+    outer_transformer_t::render_instance_t instance{outer.get(), [] (auto) {}, nullptr};
+    auto fused = instance.fused_texture();
+    REQUIRE(fused.has_value());
+    check_transform(fused->transform, {middle.get()});
+
+    middle->angle = 0.3;
+    fused = instance.fused_texture();
+    REQUIRE(fused.has_value());
+    check_transform(fused->transform, {middle.get()});
+}
+
+TEST_CASE("Chains of 2D transformers are fused in order")
+{
+    auto inner = std::make_shared<view_2d_transformer_t>(nullptr);
+    inner->translation_x = 10;
+    inner->scale_x = 3.0;
+    inner->alpha   = 0.5;
+    auto middle = std::make_shared<view_2d_transformer_t>(nullptr);
+    middle->translation_y = 20;
+    middle->scale_y = 0.25;
+    middle->angle   = 1.0;
+    middle->alpha   = 0.5;
+
+    inner->set_children_list({std::make_shared<texture_node_t>()});
+    middle->set_children_list({inner});
+    auto outer = std::make_shared<outer_transformer_t>();
+    outer->set_children_list({middle});
+
+    outer_transformer_t::render_instance_t instance{outer.get(), [] (auto) {}, nullptr};
+    auto fused = instance.fused_texture();
+    REQUIRE(fused.has_value());
+    CHECK(fused->alpha == doctest::Approx(0.25));
+    check_transform(fused->transform, {middle.get(), inner.get()});
+}
@@ -0,0 +1,91 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+#include <wayfire/plugins/common/workspace-wall.hpp>
+
+using wf::workspace_wall_update_t;
+
+static std::vector<wf::point_t> get_order(std::vector<workspace_wall_update_t> updates)
+{
+    wf::sort_workspace_wall_updates(updates);
+    std::vector<wf::point_t> order;
+    for (auto& ws : updates)
+    {
+        order.push_back({ws.i, ws.j});
+    }
+
+    return order;
+}
+
+TEST_CASE("The current workspace is updated first")
+{
+    auto order = get_order({
+        {0, 0, false, 1000, 5},
+        {1, 0, true, 10, 0},
+        {2, 0, false, 2000, 0},
+    });
+
+    REQUIRE(order.size() == 3);
+    CHECK(order[0] == wf::point_t{1, 0});
+}
+
+TEST_CASE("Deferred workspaces come before larger ones")
+{
+    auto order = get_order({
+        {0, 0, false, 4000, 0},
+        {1, 0, false, 100, 2},
+        {2, 0, false, 200, 1},
+        {0, 1, false, 3000, 0},
+    });
+
+    CHECK(order == std::vector<wf::point_t>{{1, 0}, {2, 0}, {0, 0}, {0, 1}});
+}
+
+TEST_CASE("Equal workspaces keep the grid order")
+{
+    auto order = get_order({
+        {0, 0, false, 100, 0},
+        {1, 0, false, 100, 0},
+        {0, 1, false, 100, 0},
+    });
+
+    CHECK(order == std::vector<wf::point_t>{{0, 0}, {1, 0}, {0, 1}});
+}
+
+TEST_CASE("No workspace is starved when the budget allows only one update per frame")
+{
+    // A 3x3 grid fully visible, like expo, where only the current workspace and one more fit in a frame.
+    std::vector<workspace_wall_update_t> updates;
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            updates.push_back({i, j, (i == 1) && (j == 1), 100 * (i + 1) * (j + 1), 0});
+        }
+    }
+
+    const int nr_frames = 8;
+    std::vector<int> last_update(updates.size(), -1);
+    for (int frame = 0; frame < nr_frames; frame++)
+    {
+        wf::sort_workspace_wall_updates(updates);
+        for (size_t k = 0; k < updates.size(); k++)
+        {
+            auto& ws = updates[k];
+            if (k < 2)
+            {
+                ws.skipped_frames = 0;
+                last_update[ws.i * 3 + ws.j] = frame;
+            } else
+            {
+                ++ws.skipped_frames;
+            }
+        }
+    }
+
+    // The current workspace is updated every frame, the other eight take turns.
+    CHECK(last_update[1 * 3 + 1] == nr_frames - 1);
+    for (int k = 0; k < 9; k++)
+    {
+        CHECK(last_update[k] >= 0);
+    }
+}
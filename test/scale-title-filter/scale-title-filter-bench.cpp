@@ -0,0 +1,148 @@
+#include "../../plugins/scale/scale-title-filter-index.hpp"
+#include "../bench/measure.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * Type a filter character by character (and delete it again) with 500 views, once by normalizing every
+ * title and app-id on each keystroke (like scale-title-filter used to do), and once with the search index.
+ */
+
+static constexpr int NR_VIEWS = 500;
+static constexpr int NR_ROUNDS = 20;
+
+static const std::string typed_filter = "Document 1";
+
+struct fake_view_t
+{
+    uint32_t id;
+    std::string title;
+    std::string app_id;
+};
+
+static std::string fix_case(std::string string)
+{
+    std::transform(string.begin(), string.end(), string.begin(), [] (unsigned char c) -> unsigned char
+    {
+        if (std::isspace(c))
+        {
+            return ' ';
+        }
+
+        return (c <= 127) ? (unsigned char)std::tolower(c) : c;
+    });
+    return string;
+}
+
+/** Run @count_matches for every prefix of the filter, while typing it and then while deleting it. */
+template<class Callback>
+static size_t type_filter(Callback&& count_matches)
+{
+    size_t total = 0;
+    for (size_t len = 1; len <= typed_filter.size(); len++)
+    {
+        total += count_matches(typed_filter.substr(0, len));
+    }
+
+    for (size_t len = typed_filter.size() - 1; len >= 1; len--)
+    {
+        total += count_matches(typed_filter.substr(0, len));
+    }
+
+    return total;
+}
+
+int main()
+{
+    std::vector<fake_view_t> views;
+    for (int i = 0; i < NR_VIEWS; i++)
+    {
+        views.push_back({(uint32_t)i + 1,
+            "Document " + std::to_string(i * 7) + " - Some Long Application Name With A Version 1.2.3",
+            "org.example.App" + std::to_string(i % 30)});
+    }
+
+    size_t baseline_matches = 0;
+    double baseline = wf::bench::measure_ms([&] ()
+    {
+        for (int round = 0; round < NR_ROUNDS; round++)
+        {
+            baseline_matches += type_filter([&] (std::string filter)
+            {
+                size_t count = 0;
+                filter = fix_case(filter);
+                for (auto& view : views)
+                {
+                    auto title  = fix_case(view.title);
+                    auto app_id = fix_case(view.app_id);
+                    count += (title.find(filter) != std::string::npos) ||
+                        (app_id.find(filter) != std::string::npos);
+                }
+
+                return count;
+            });
+        }
+    });
+
+    auto run_indexed = [&] (bool fuzzy, size_t& matches)
+    {
+        return wf::bench::measure_ms([&] ()
+        {
+            for (int round = 0; round < NR_ROUNDS; round++)
+            {
+                // A new index for each scale session.
+                wf::title_filter_index_t index;
+                index.configure(false, fuzzy);
+                matches += type_filter([&] (const std::string& filter)
+                {
+                    size_t count = 0;
+                    for (auto& view : views)
+                    {
+                        if (!index.contains(view.id))
+                        {
+                            index.set_entry(view.id, view.title, view.app_id);
+                        }
+                    }
+
+                    index.set_filter(filter);
+                    for (auto& view : views)
+                    {
+                        count += index.matches(view.id);
+                    }
+
+                    return count;
+                });
+            }
+        });
+    };
+
+    size_t indexed_matches = 0;
+    size_t fuzzy_matches   = 0;
+    double indexed = run_indexed(false, indexed_matches);
+    double fuzzy   = run_indexed(true, fuzzy_matches);
+
+    std::cout << NR_ROUNDS << " sessions with " << NR_VIEWS << " views:" << std::endl;
+    std::cout << "Normalize on every keystroke: " << baseline << " ms" << std::endl;
+    std::cout << "Search index: " << indexed << " ms" << std::endl;
+    std::cout << "Search index, fuzzy: " << fuzzy << " ms" << std::endl;
+
+    if (baseline_matches != indexed_matches)
+    {
+        std::cerr << "Mismatch: " << baseline_matches << " matches vs " << indexed_matches <<
+            " matches" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (fuzzy_matches < indexed_matches)
+    {
+        std::cerr << "Fuzzy matching found fewer matches than substring matching" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
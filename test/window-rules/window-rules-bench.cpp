@@ -0,0 +1,129 @@
+#include <wayfire/lexer/lexer.hpp>
+#include <wayfire/parser/rule_parser.hpp>
+#include <wayfire/rule/rule.hpp>
+#include <wayfire/util/log.hpp>
+#include "../../plugins/window-rules/rule-index.hpp"
+#include "../bench/measure.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Apply 500 rules to 200 views on each signal, once by trying every rule with
+ * uncached property lookups (like window-rules used to do), and once with the
+ * signal index and the property cache.
+ */
+
+static constexpr int NR_RULES = 500;
+static constexpr int NR_VIEWS = 200;
+
+static const std::vector<std::string> signals = {
+    "created", "maximized", "unmaximized", "minimized", "fullscreened"
+};
+
+class fake_view_t : public wf::access_interface_t
+{
+  public:
+    std::map<std::string, wf::variant_t> properties;
+
+    wf::variant_t get(const std::string & identifier, bool & error) override
+    {
+        auto it = properties.find(identifier);
+        error = (it == properties.end());
+        return error ? wf::variant_t{std::string("")} : it->second;
+    }
+};
+
+class counting_action_interface_t : public wf::action_interface_t
+{
+  public:
+    int executed = 0;
+
+    bool execute(const std::string & name, const std::vector<wf::variant_t> & args) override
+    {
+        ++executed;
+        return false;
+    }
+};
+
+int main()
+{
+    wf::log::initialize_logging(std::cout, wf::log::LOG_LEVEL_ERROR, wf::log::LOG_COLOR_MODE_OFF);
+
+    std::vector<std::shared_ptr<wf::rule_t>> all_rules;
+    wf::signal_rule_index_t<std::shared_ptr<wf::rule_t>> index;
+    wf::lexer_t lexer;
+    for (int i = 0; i < NR_RULES; i++)
+    {
+        std::string text = "on " + signals[i % signals.size()] +
+            " if app_id is \"app-" + std::to_string(i % 40) + "\" | title contains \"doc-" +
+            std::to_string(i) + "\" then set alpha 0.9";
+        lexer.reset(text);
+        auto rule = wf::rule_parser_t().parse(lexer);
+        if (!rule)
+        {
+            std::cerr << "Failed to parse rule " << text << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        all_rules.push_back(rule);
+        index.add(wf::get_rule_signal(text), rule);
+    }
+
+    std::vector<fake_view_t> views(NR_VIEWS);
+    for (int i = 0; i < NR_VIEWS; i++)
+    {
+        views[i].properties["app_id"] = std::string("app-") + std::to_string(i % 50);
+        views[i].properties["title"]  = std::string("doc-") + std::to_string(i * 3) + " - editor";
+        views[i].properties["role"]   = std::string("TOPLEVEL");
+        views[i].properties["fullscreen"] = false;
+    }
+
+    counting_action_interface_t baseline_actions;
+    double baseline = wf::bench::measure_ms([&] ()
+    {
+        for (auto& signal : signals)
+        {
+            for (auto& view : views)
+            {
+                for (auto& rule : all_rules)
+                {
+                    rule->apply(signal, view, baseline_actions);
+                }
+            }
+        }
+    });
+
+    counting_action_interface_t indexed_actions;
+    double indexed = wf::bench::measure_ms([&] ()
+    {
+        for (auto& signal : signals)
+        {
+            for (auto& view : views)
+            {
+                wf::cached_access_interface_t cached{view};
+                wf::invalidating_action_interface_t actions{indexed_actions, cached};
+                for (auto& rule : index.get(signal))
+                {
+                    rule->apply(signal, cached, actions);
+                }
+            }
+        }
+    });
+
+    std::cout << "All rules, uncached: " << baseline << " ms" << std::endl;
+    std::cout << "Indexed rules, cached properties: " << indexed << " ms" << std::endl;
+
+    if (baseline_actions.executed != indexed_actions.executed)
+    {
+        std::cerr << "Mismatch: " << baseline_actions.executed << " actions vs " <<
+            indexed_actions.executed << " actions" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}